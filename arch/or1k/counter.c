@@ -5,6 +5,10 @@
 
 #include <counter.h>
 #include <spr.h>
+#include <stdint.h>
+
+static uint32_t counter_high;
+static uint32_t counter_last;
 
 void
 counter_init(void)
@@ -18,3 +22,16 @@ counter_read(void)
 {
 	return mfspr(SPR_TICK_TTCR_ADDR);
 }
+
+uint64_t
+counter_read_64(void)
+{
+	uint32_t now = counter_read();
+
+	/* The counter only goes backward when it wraps. */
+	if (now < counter_last)
+		++counter_high;
+	counter_last = now;
+
+	return (uint64_t)counter_high << 32 | now;
+}
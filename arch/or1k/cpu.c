@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <counter.h>
+#include <cpu.h>
+#include <spr.h>
+#include <stdint.h>
+
+#define DOZE_MIN_CYCLES 64
+
+#define TTMR_CONTINUE   (SPR_TICK_TTMR_MODE_CONTINUE << SPR_TICK_TTMR_MODE_LSB)
+
+void
+cpu_disable_irqs(void)
+{
+	mtspr(SPR_SYS_SR_ADDR, mfspr(SPR_SYS_SR_ADDR) & ~SPR_SYS_SR_IEE_MASK);
+}
+
+void
+cpu_doze(uint64_t timeout)
+{
+	uint64_t now = counter_read_64();
+	uint32_t cycles;
+
+	/* Skip doze mode if the tick timer could pass the match value
+	 * before it is programmed, or if the timeout already expired. */
+	if (timeout < now + DOZE_MIN_CYCLES)
+		return;
+
+	/* The tick timer only compares the low 28 bits of the counter. */
+	if (timeout - now > SPR_TICK_TTMR_TP_MASK)
+		cycles = SPR_TICK_TTMR_TP_MASK;
+	else
+		cycles = timeout - now;
+
+	/* Raise a (masked) tick timer interrupt when the timeout expires. */
+	mtspr(SPR_TICK_TTMR_ADDR, TTMR_CONTINUE | SPR_TICK_TTMR_IE_MASK |
+	      (((uint32_t)now + cycles) & SPR_TICK_TTMR_TP_MASK));
+
+	/* Stop the CPU clock until any interrupt is pending. */
+	mtspr(SPR_POWER_PMR_ADDR, SPR_POWER_PMR_DME_MASK);
+
+	/* Disable the tick timer interrupt and clear its pending flag. */
+	mtspr(SPR_TICK_TTMR_ADDR, TTMR_CONTINUE);
+}
+
+void
+cpu_enable_irqs(void)
+{
+	mtspr(SPR_SYS_SR_ADDR, mfspr(SPR_SYS_SR_ADDR) | SPR_SYS_SR_IEE_MASK);
+}
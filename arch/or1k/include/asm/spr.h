@@ -2585,8 +2585,31 @@
 #define SPR_POWER_GROUP     0x08
 
 /* Power Management Register */
-#define SPR_POWER_PMR_INDEX U(0x000)
-#define SPR_POWER_PMR_ADDR  U(0x4000)
+#define SPR_POWER_PMR_INDEX         U(0x000)
+#define SPR_POWER_PMR_ADDR          U(0x4000)
+
+/* Slowdown Factor */
+#define SPR_POWER_PMR_SDF_LSB       0
+#define SPR_POWER_PMR_SDF_MSB       3
+#define SPR_POWER_PMR_SDF_BITS      4
+#define SPR_POWER_PMR_SDF_MASK      U(0x0000000f)
+#define SPR_POWER_PMR_SDF_GET(x)    (((x) >> 0) & U(0x0000000f))
+#define SPR_POWER_PMR_SDF_SET(x, y) (((x) & U(0xfffffff0)) | \
+	                             ((y) << 0))
+
+/* Doze Mode Enable */
+#define SPR_POWER_PMR_DME_OFFSET    4
+#define SPR_POWER_PMR_DME_MASK      0x00000010
+#define SPR_POWER_PMR_DME_GET(x)    (((x) >> 4) & 0x1)
+#define SPR_POWER_PMR_DME_SET(x, y) (((x) & U(0xffffffef)) | \
+	                             ((!!(y)) << 4))
+
+/* Sleep Mode Enable */
+#define SPR_POWER_PMR_SME_OFFSET    5
+#define SPR_POWER_PMR_SME_MASK      0x00000020
+#define SPR_POWER_PMR_SME_GET(x)    (((x) >> 5) & 0x1)
+#define SPR_POWER_PMR_SME_SET(x, y) (((x) & U(0xffffffdf)) | \
+	                             ((!!(y)) << 5))
 
 /*******************************************/
 /* Programmable Interrupt Controller Group */
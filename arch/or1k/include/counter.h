@@ -23,4 +23,14 @@ void counter_init(void);
  */
 uint32_t counter_read(void);
 
+/**
+ * Read the system counter, extended to 64 bits.
+ *
+ * The upper 32 bits are maintained in software by detecting wraparound, so
+ * this function must be called at least once per wrap of the 32-bit counter.
+ * The main loop does this implicitly by polling timers. The extended value
+ * is reset along with the rest of .bss when the firmware restarts.
+ */
+uint64_t counter_read_64(void);
+
 #endif /* COUNTER_H */
@@ -0,0 +1,34 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef CPU_H
+#define CPU_H
+
+#include <stdint.h>
+
+/**
+ * Prevent external interrupts from being taken by the CPU.
+ *
+ * Pending interrupts can still end doze mode while they are disabled.
+ */
+void cpu_disable_irqs(void);
+
+/**
+ * Put the CPU in doze mode until an interrupt is pending or a timeout expires.
+ *
+ * Interrupts should be disabled while calling this function, so an interrupt
+ * arriving just before entering doze mode is not handled (and masked) until
+ * after doze mode ends.
+ *
+ * @param timeout A timeout returned by timeout_set() or timer_next_deadline().
+ */
+void cpu_doze(uint64_t timeout);
+
+/**
+ * Allow external interrupts to be taken by the CPU.
+ */
+void cpu_enable_irqs(void);
+
+#endif /* CPU_H */
@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <clock_list.h>
+#include <scpi_protocol.h>
+#include <util.h>
+#include <clock/ccu.h>
+
+#define R_CLOCK(id, name, flags) { { &r_ccu.dev, (id) }, (name), (flags) }
+#define CLOCK(id, name, flags)   { { &ccu.dev, (id) }, (name), (flags) }
+
+#define RO SCPI_FLAG_READABLE
+#define RW (SCPI_FLAG_READABLE | SCPI_FLAG_WRITABLE)
+
+/*
+ * Clocks used by the firmware itself (for example, the AR100 clock) are only
+ * readable. Module clocks are writable, but changes are refused while the
+ * firmware holds a reference to the clock.
+ */
+#if CONFIG(CLOCK_SERVICE)
+const struct scpi_clock scpi_clocks[] = {
+#if CONFIG(PLATFORM_H6)
+	R_CLOCK(CLK_AR100,  "ar100",    RO),
+	R_CLOCK(CLK_R_APB1, "r_apb1",   RO),
+	R_CLOCK(CLK_R_APB2, "r_apb2",   RO),
+	R_CLOCK(CLK_R_CIR,  "r_cir",    RW),
+	R_CLOCK(CLK_R_W1,   "r_w1",     RW),
+	CLOCK(CLK_PLL_CPUX, "pll_cpux", RO),
+#else
+	R_CLOCK(CLK_AR100,  "ar100",    RO),
+	R_CLOCK(CLK_APB0,   "apb0",     RO),
+	R_CLOCK(CLK_R_CIR,  "r_cir",    RW),
+#if CONFIG(PLATFORM_A64)
+	CLOCK(CLK_PLL_CPUX, "pll_cpux", RO),
+#endif
+#endif
+};
+
+const uint8_t scpi_clock_count = ARRAY_SIZE(scpi_clocks);
+#else
+/* ISO C does not allow empty arrays, so provide an unused entry. */
+const struct scpi_clock scpi_clocks[1];
+
+const uint8_t scpi_clock_count = 0;
+#endif
@@ -7,8 +7,10 @@
 #include <division.h>
 #include <regmap.h>
 #include <scpi.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <timeout.h>
+#include <timer.h>
 #include <util.h>
 #include <mfd/axp20x.h>
 
@@ -22,16 +24,16 @@ extern uint32_t __stack_end[];
 
 static uint32_t *cursor;
 
-static uint32_t timeout;
+static struct timer timer;
 
 void
 debug_print_battery(void)
 {
 	const struct regmap *map = &axp20x.map;
 	uint32_t current, voltage;
-	uint8_t  hi, lo, val;
+	uint8_t  buf[2], val;
 
-	if (!timeout_expired(timeout))
+	if (timer_running(&timer))
 		return;
 	if (regmap_user_probe(map))
 		return;
@@ -43,17 +45,13 @@ debug_print_battery(void)
 	if (regmap_read(map, 0x00, &val) || (val & BIT(2)))
 		goto err_put_mfd;
 
-	if (regmap_read(map, 0x78, &hi))
+	if (regmap_bulk_read(map, 0x78, buf, sizeof(buf)))
 		goto err_put_mfd;
-	if (regmap_read(map, 0x79, &lo))
-		goto err_put_mfd;
-	voltage = udiv_round(((hi << 4) | (lo & 0xf)) * 1100, 1000);
+	voltage = udiv_round(((buf[0] << 4) | (buf[1] & 0xf)) * 1100, 1000);
 
-	if (regmap_read(map, 0x7c, &hi))
-		goto err_put_mfd;
-	if (regmap_read(map, 0x7d, &lo))
+	if (regmap_bulk_read(map, 0x7c, buf, sizeof(buf)))
 		goto err_put_mfd;
-	current = (hi << 4) | (lo & 0xf);
+	current = (buf[0] << 4) | (buf[1] & 0xf);
 
 	if (!cursor || (uintptr_t)cursor + 4 >= (uintptr_t)__scpi_mem)
 		cursor = __stack_end;
@@ -65,5 +63,5 @@ debug_print_battery(void)
 
 err_put_mfd:
 	regmap_user_release(map);
-	timeout = timeout_set(MEASUREMENT_INTERVAL);
+	timer_start(&timer, NULL, MEASUREMENT_INTERVAL, false);
 }
@@ -7,13 +7,27 @@
 #include <debug.h>
 #include <division.h>
 #include <system.h>
+#include <timeout.h>
+#include <timer.h>
 
-#define ITERATIONS 10000
+#define MEASUREMENT_INTERVAL (1 * USEC_PER_SEC) /* 1s */
+
+static struct timer timer;
 
 static uint32_t cycles;
 static uint32_t iterations;
 static uint8_t  last_state;
 
+static void
+debug_latency_timer_fn(struct timer *t UNUSED)
+{
+	if (!iterations)
+		return;
+
+	info("State %u: %u cycles/iteration", last_state,
+	     udiv_round(counter_read() - cycles, iterations));
+}
+
 void
 debug_print_latency(uint8_t current_state)
 {
@@ -21,8 +35,9 @@ debug_print_latency(uint8_t current_state)
 		cycles     = counter_read();
 		iterations = 0;
 		last_state = current_state;
-	} else if (iterations < ITERATIONS && ++iterations == ITERATIONS) {
-		info("State %u: %u cycles/iteration", current_state,
-		     udiv_round(counter_read() - cycles, ITERATIONS));
+		timer_start(&timer, debug_latency_timer_fn,
+		            MEASUREMENT_INTERVAL, false);
+	} else if (timer_running(&timer)) {
+		++iterations;
 	}
 }
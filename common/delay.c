@@ -10,7 +10,7 @@
 void
 udelay(uint32_t useconds)
 {
-	uint32_t timeout = timeout_set(useconds);
+	uint64_t timeout = timeout_set(useconds);
 
 	while (!timeout_expired(timeout)) {
 		/* Do nothing. */
@@ -6,7 +6,59 @@
 #include <debug.h>
 #include <device.h>
 #include <error.h>
+#include <intrusive.h>
 #include <stddef.h>
+#include <timer.h>
+
+/** Devices with no references that have not been released yet. */
+static struct device_autosuspend_state *idle_devices;
+
+static inline struct device_autosuspend_state *
+to_autosuspend_state(const struct device *dev)
+{
+	return container_of(dev->state, struct device_autosuspend_state, ds);
+}
+
+static void
+device_release(const struct device *dev)
+{
+	debug("%s: Releasing", dev->name);
+	dev->drv->release(dev);
+}
+
+/**
+ * Remove a device from the idle list. Returns false if it was not idle.
+ */
+static bool
+device_unidle(const struct device *dev)
+{
+	struct device_autosuspend_state **link = &idle_devices;
+	struct device_autosuspend_state *state;
+
+	if (!dev->drv->autosuspend_delay)
+		return false;
+
+	state = to_autosuspend_state(dev);
+	while (*link && *link != state)
+		link = &(*link)->next;
+	if (!*link)
+		return false;
+
+	*link = state->next;
+	timer_stop(&state->timer);
+
+	return true;
+}
+
+static void
+device_autosuspend(struct timer *timer)
+{
+	struct device_autosuspend_state *state =
+		container_of(timer, struct device_autosuspend_state, timer);
+
+	device_unidle(state->dev);
+	device_release(state->dev);
+}
 
 bool
 device_active(const struct device *dev)
@@ -22,7 +74,8 @@ device_get(const struct device *dev)
 	if (!dev)
 		return ENODEV;
 
-	if (!dev->state->refcount) {
+	/* An idle device is still initialized, so it needs no probe. */
+	if (!dev->state->refcount && !device_unidle(dev)) {
 		if ((err = dev->drv->probe(dev))) {
 			warn("%s: Probe failed: %d", dev->name, err);
 			return err;
@@ -45,11 +98,42 @@ device_get_or_null(const struct device *dev)
 void
 device_put(const struct device *dev)
 {
+	struct device_autosuspend_state *state;
+
 	if (!dev || --dev->state->refcount)
 		return;
 
-	debug("%s: Releasing", dev->name);
-	dev->drv->release(dev);
+	if (!dev->drv->autosuspend_delay) {
+		device_release(dev);
+		return;
+	}
+
+	/* Keep the device initialized in case it is needed again soon. */
+	state        = to_autosuspend_state(dev);
+	state->dev   = dev;
+	state->next  = idle_devices;
+	idle_devices = state;
+	timer_start(&state->timer, device_autosuspend,
+	            dev->drv->autosuspend_delay, false);
+}
+
+void
+device_release_idle(void)
+{
+	struct device_autosuspend_state *state;
+
+	/* Releasing a device may cause its parent devices to become idle. */
+	while ((state = idle_devices)) {
+		device_unidle(state->dev);
+		device_release(state->dev);
+	}
+}
+
+void
+device_release_if_idle(const struct device *dev)
+{
+	if (device_unidle(dev))
+		device_release(dev);
 }
 
 int
@@ -3,8 +3,11 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <error.h>
 #include <regulator_list.h>
+#include <scpi_protocol.h>
 #include <stddef.h>
+#include <util.h>
 #include <regulator/axp803.h>
 #include <regulator/axp805.h>
 #include <regulator/gpio.h>
@@ -65,3 +68,63 @@ const struct regulator_handle vdd_sys_supply = {
 	.dev = NULL,
 #endif
 };
+
+/*
+ * Only regulators with voltage control are listed. The CPU supply belongs
+ * to DVFS, and the others power the DRAM, PLLs, and the firmware itself, so
+ * SCPI clients may read their voltages but not change them. The voltages
+ * never change while the rich OS is running. No entry may be writable, since
+ * the firmware cannot use the PMIC bus while the rich OS owns it.
+ */
+#if CONFIG(PSU_SERVICE) && \
+	(CONFIG(REGULATOR_AXP803) || CONFIG(REGULATOR_AXP805))
+const struct scpi_psu scpi_psus[] = {
+	{ .regulator = &cpu_supply,     .flags = SCPI_FLAG_READABLE },
+	{ .regulator = &dram_supply,    .flags = SCPI_FLAG_READABLE },
+	{ .regulator = &vcc_pll_supply, .flags = SCPI_FLAG_READABLE },
+	{ .regulator = &vdd_sys_supply, .flags = SCPI_FLAG_READABLE },
+};
+
+const uint8_t scpi_psu_count = ARRAY_SIZE(scpi_psus);
+
+static uint16_t scpi_psu_voltages[ARRAY_SIZE(scpi_psus)];
+#elif CONFIG(PSU_SERVICE) && CONFIG(REGULATOR_SY8106A)
+const struct scpi_psu scpi_psus[] = {
+	{ .regulator = &cpu_supply,     .flags = SCPI_FLAG_READABLE },
+};
+
+const uint8_t scpi_psu_count = ARRAY_SIZE(scpi_psus);
+
+static uint16_t scpi_psu_voltages[ARRAY_SIZE(scpi_psus)];
+#else
+/* ISO C does not allow empty arrays, so provide an unused entry. */
+const struct scpi_psu scpi_psus[1];
+
+const uint8_t scpi_psu_count = 0;
+
+static uint16_t scpi_psu_voltages[1];
+#endif
+
+int
+regulator_list_get_voltage(uint8_t id, uint32_t *voltage)
+{
+	/* A voltage of zero means the last read failed. */
+	if (!scpi_psu_voltages[id])
+		return EIO;
+
+	*voltage = scpi_psu_voltages[id];
+
+	return SUCCESS;
+}
+
+void
+regulator_list_update(void)
+{
+	for (uint8_t id = 0; id < scpi_psu_count; ++id) {
+		uint32_t voltage;
+
+		if (regulator_get_voltage(scpi_psus[id].regulator, &voltage))
+			voltage = 0;
+		scpi_psu_voltages[id] = voltage;
+	}
+}
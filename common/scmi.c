@@ -0,0 +1,157 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <debug.h>
+#include <error.h>
+#include <msgbox.h>
+#include <scmi.h>
+#include <scpi.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <timeout.h>
+#include <timer.h>
+
+/*
+ * SCMI replaces SCPI for the non-secure client, so it uses that client's
+ * shared memory and mailbox channels. The A2P area is the SCPI RX buffer, and
+ * the P2A area is the SCPI TX buffer. Notifications and delayed responses
+ * need their own doorbell, so they use an otherwise unallocated channel.
+ */
+#define SCMI_MEM_AREA   (__scpi_mem[SCPI_CLIENTS - SCPI_CLIENT_EL2 - 1])
+#define A2P_SHMEM       ((struct scmi_shmem *)&SCMI_MEM_AREA.rx_msg)
+#define P2A_SHMEM       ((struct scmi_shmem *)&SCMI_MEM_AREA.tx_msg)
+
+#define A2P_RX_CHAN     2
+#define A2P_TX_CHAN     3
+#define P2A_TX_CHAN     7
+
+/* Any value works, since the mailbox is only used as a doorbell. */
+#define SCMI_DOORBELL   BIT(0)
+
+#define SCMI_QUEUE_SIZE 4
+
+#define SCMI_TX_TIMEOUT (10 * USEC_PER_MSEC) /* 10ms */
+
+struct scmi_queued_msg {
+	uint32_t header;
+	uint32_t payload[SCMI_QUEUED_PAYLOAD_WORDS];
+	uint8_t  size;
+};
+
+struct scmi_state {
+	struct timer           timeout;
+	struct scmi_queued_msg queue[SCMI_QUEUE_SIZE];
+	uint8_t                queue_head;
+	uint8_t                queue_len;
+	bool                   initialized;
+};
+
+/** The shared memory area, with an address defined in the linker script. */
+extern struct scpi_mem __scpi_mem[SCPI_CLIENTS];
+
+/** The current state of the transport. */
+static struct scmi_state scmi_state;
+
+/**
+ * Send the oldest queued message to the agent, if the agent has finished
+ * processing the previous message.
+ */
+static void
+scmi_send_queued_message(const struct device *mailbox)
+{
+	struct scmi_shmem *shmem = P2A_SHMEM;
+	struct scmi_state *state = &scmi_state;
+	struct scmi_queued_msg *msg;
+	int err;
+
+	if (!state->queue_len || !(shmem->status & SCMI_CHANNEL_FREE))
+		return;
+
+	msg = &state->queue[state->queue_head];
+	state->queue_head = (state->queue_head + 1) % SCMI_QUEUE_SIZE;
+	state->queue_len--;
+
+	/* The agent sets the free bit again once it has read the message. */
+	shmem->status = 0;
+	shmem->length = sizeof(shmem->header) + msg->size;
+	shmem->header = msg->header;
+	for (uint8_t i = 0; i < SCMI_QUEUED_PAYLOAD_WORDS; ++i)
+		shmem->payload[i] = msg->payload[i];
+
+	/* Ensure the message is fully written before notifying the agent. */
+	barrier();
+
+	/* Poll for the agent to free the area, but only for a short time. */
+	timer_start(&state->timeout, NULL, SCMI_TX_TIMEOUT, false);
+
+	if ((err = msgbox_send(mailbox, P2A_TX_CHAN, SCMI_DOORBELL)))
+		warn("SCMI: Send error: %d", err);
+}
+
+int
+scmi_create_message(uint32_t header, const uint32_t *payload, uint8_t size)
+{
+	struct scmi_state *state = &scmi_state;
+	struct scmi_queued_msg *msg;
+	uint8_t tail;
+
+	assert(size <= sizeof(msg->payload));
+
+	if (state->queue_len == SCMI_QUEUE_SIZE) {
+		warn("SCMI: Dropped message %08x", header);
+		return EBUSY;
+	}
+
+	tail = (state->queue_head + state->queue_len) % SCMI_QUEUE_SIZE;
+	msg  = &state->queue[tail];
+	msg->header = header;
+	msg->size   = size;
+	for (uint8_t i = 0; i < SCMI_QUEUED_PAYLOAD_WORDS; ++i)
+		msg->payload[i] = 4 * i < size ? payload[i] : 0;
+	state->queue_len++;
+
+	return SUCCESS;
+}
+
+bool
+scmi_poll(const struct device *mailbox)
+{
+	struct scmi_shmem *shmem = A2P_SHMEM;
+	struct scmi_state *state = &scmi_state;
+	uint32_t msg;
+	int err;
+
+	/* Both areas start out owned by the agent. */
+	if (!state->initialized) {
+		A2P_SHMEM->status = SCMI_CHANNEL_FREE;
+		P2A_SHMEM->status = SCMI_CHANNEL_FREE;
+		state->initialized = true;
+	}
+
+	/* Commands are handled synchronously, so the response is written to
+	 * the A2P area before the agent regains ownership of it. */
+	if (msgbox_receive(mailbox, A2P_RX_CHAN, &msg) == SUCCESS) {
+		if (!(shmem->status & SCMI_CHANNEL_FREE)) {
+			scmi_handle_cmd(shmem);
+			barrier();
+			shmem->status = SCMI_CHANNEL_FREE;
+			barrier();
+
+			/* Agents may poll for completion instead. */
+			if ((shmem->flags & SCMI_FLAG_INTERRUPT) &&
+			    (err = msgbox_send(mailbox, A2P_TX_CHAN,
+			                       SCMI_DOORBELL)))
+				warn("SCMI: Send error: %d", err);
+		}
+		msgbox_ack_rx(mailbox, A2P_RX_CHAN);
+	}
+
+	scmi_send_queued_message(mailbox);
+
+	/* The agent freeing the P2A area does not generate an IRQ. If the
+	 * agent is slow, retry after the next IRQ or timer instead. */
+	return state->queue_len > 0 && timer_running(&state->timeout);
+}
@@ -0,0 +1,1131 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <bitfield.h>
+#include <clock.h>
+#include <clock_list.h>
+#include <css.h>
+#include <error.h>
+#include <scmi.h>
+#include <scpi_protocol.h>
+#include <sensor_list.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <util.h>
+#include <version.h>
+#include <platform/css.h>
+
+#define SCMI_VERSION(x, y) ((x) << 16 | (y))
+
+/** The only agent is the rich OS. Agent 0 is reserved for the platform. */
+#define SCMI_AGENT_ID      1
+
+/** The largest command payload accepted by any handler, in words. */
+#define SCMI_RX_WORDS      4
+
+/** The response payload space remaining after the status word. */
+#define SCMI_TX_WORDS      (SCMI_PAYLOAD_WORDS - 1)
+
+#define PERF_MAX_LEVELS    ((SCMI_TX_WORDS - 1) / 3)
+#define SENSOR_MAX_DESCS   ((SCMI_TX_WORDS - 1) / 7)
+#define SENSOR_MAX_TRIPS   4
+
+/* SCMI sensor type for degrees Celsius, with a unit exponent of -3. */
+#define SENSOR_TYPE_MILLIDEGREES_C (2 | (-3 & 0x1f) << 11)
+
+/* Trip point event control modes. */
+enum {
+	TRIP_DISABLED   = 0,
+	TRIP_ASCENDING  = 1,
+	TRIP_DESCENDING = 2,
+	TRIP_BOTH       = 3,
+};
+
+struct scmi_cmd {
+	/** Handler that processes a command and fills in the response. */
+	int     (*handler)(const uint32_t *rx_payload, uint32_t *tx_payload,
+	                   uint16_t *tx_size);
+	/** Expected size of the command payload. */
+	uint8_t rx_size;
+};
+
+struct scmi_protocol {
+	/** The protocol-specific commands, indexed by message ID. */
+	const struct scmi_cmd *cmds;
+	/** The protocol version reported to the agent. */
+	uint32_t               version;
+	/** The protocol ID. */
+	uint8_t                id;
+	/** The number of entries in the command table. */
+	uint8_t                cmd_count;
+};
+
+struct scmi_sensor_trip {
+	/** The trip point value. */
+	uint32_t value;
+	/** The trip point event control mode (TRIP_*). */
+	uint8_t  mode;
+	/** Whether the agent wants to receive trip point events. */
+	bool     notify;
+};
+
+/** The token of the command being handled, used for delayed responses. */
+static uint32_t scmi_token;
+
+#if CONFIG(DVFS)
+/** The performance limits for each domain, in kHz, or zero if unset. */
+static uint32_t scmi_perf_max[MAX_CLUSTERS];
+static uint32_t scmi_perf_min[MAX_CLUSTERS];
+#endif
+
+/** The trip point configuration for each sensor. */
+static struct scmi_sensor_trip scmi_sensor_trips[SENSOR_MAX_TRIPS];
+
+#if CONFIG(CLOCK_SERVICE)
+/** The clocks the agent holds a reference to, indexed by clock ID. */
+static uint32_t scmi_clocks_held;
+#endif
+
+/** The protocols other than the base protocol, in increasing order. */
+static const uint8_t scmi_protocol_ids[] = {
+	SCMI_PROTOCOL_POWER,
+	SCMI_PROTOCOL_SYSTEM,
+#if CONFIG(DVFS)
+	SCMI_PROTOCOL_PERF,
+#endif
+#if CONFIG(CLOCK_SERVICE)
+	SCMI_PROTOCOL_CLOCK,
+#endif
+	SCMI_PROTOCOL_SENSOR,
+};
+
+/*
+ * Copy a NUL-terminated name into a fixed-size response field.
+ */
+static void
+scmi_put_name(uint32_t *tx_payload, const char *name)
+{
+	for (uint8_t i = 0; i < SCMI_NAME_SIZE / sizeof(uint32_t); ++i)
+		tx_payload[i] = 0;
+	/* Always leave room for the terminating NUL. */
+	for (uint8_t i = 0; i < SCMI_NAME_SIZE - 1 && name[i]; ++i)
+		tx_payload[i / 4] |= (uint32_t)name[i] << (8 * (i % 4));
+}
+
+/*
+ * Name a CPU cluster power or performance domain.
+ */
+static void
+scmi_put_cluster_name(uint32_t *tx_payload, uint32_t cluster)
+{
+	char name[] = "cluster0";
+
+	name[7] += cluster;
+	scmi_put_name(tx_payload, name);
+}
+
+/*
+ * Queue a delayed response for the command being handled.
+ */
+static int
+scmi_delayed_response(uint8_t protocol, uint8_t message,
+                      const uint32_t *payload, uint8_t size)
+{
+	uint32_t header = SCMI_HEADER(protocol, message,
+	                              SCMI_TYPE_DELAYED_RESPONSE, scmi_token);
+
+	return scmi_create_message(header, payload, size) ? SCMI_BUSY
+	                                                  : SCMI_SUCCESS;
+}
+
+/*
+ * Base protocol: PROTOCOL_ATTRIBUTES.
+ */
+static int
+scmi_base_attributes_handler(const uint32_t *rx_payload UNUSED,
+                             uint32_t *tx_payload, uint16_t *tx_size)
+{
+	tx_payload[0] = SCMI_AGENT_ID << 8 | ARRAY_SIZE(scmi_protocol_ids);
+	*tx_size      = sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Base protocol: BASE_DISCOVER_VENDOR.
+ */
+static int
+scmi_base_vendor_handler(const uint32_t *rx_payload UNUSED,
+                         uint32_t *tx_payload, uint16_t *tx_size)
+{
+	scmi_put_name(tx_payload, "Crust");
+	*tx_size = SCMI_NAME_SIZE;
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Base protocol: BASE_DISCOVER_SUB_VENDOR.
+ */
+static int
+scmi_base_sub_vendor_handler(const uint32_t *rx_payload UNUSED,
+                             uint32_t *tx_payload, uint16_t *tx_size)
+{
+	scmi_put_name(tx_payload, "Allwinner");
+	*tx_size = SCMI_NAME_SIZE;
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Base protocol: BASE_DISCOVER_IMPLEMENTATION_VERSION.
+ */
+static int
+scmi_base_impl_version_handler(const uint32_t *rx_payload UNUSED,
+                               uint32_t *tx_payload, uint16_t *tx_size)
+{
+	tx_payload[0] = (VERSION_MAJOR & 0xff) << 24 |
+	                (VERSION_MINOR & 0xff) << 16 |
+	                (VERSION_PATCH & 0xffff);
+	*tx_size      = sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Base protocol: BASE_DISCOVER_LIST_PROTOCOLS.
+ */
+static int
+scmi_base_list_protocols_handler(const uint32_t *rx_payload,
+                                 uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t skip = rx_payload[0];
+	uint32_t count;
+
+	if (skip > ARRAY_SIZE(scmi_protocol_ids))
+		return SCMI_INVALID_PARAMETERS;
+
+	count = ARRAY_SIZE(scmi_protocol_ids) - skip;
+	tx_payload[0] = count;
+	for (uint32_t i = 0; i < count; i += 4)
+		tx_payload[1 + i / 4] = 0;
+	for (uint32_t i = 0; i < count; ++i)
+		tx_payload[1 + i / 4] |= scmi_protocol_ids[skip + i] <<
+		                         (8 * (i % 4));
+	*tx_size = sizeof(uint32_t) * (1 + (count + 3) / 4);
+
+	return SCMI_SUCCESS;
+}
+
+static const struct scmi_cmd scmi_base_cmds[] = {
+	[SCMI_PROTOCOL_ATTRIBUTES] = {
+		.handler = scmi_base_attributes_handler,
+	},
+	[SCMI_BASE_DISCOVER_VENDOR] = {
+		.handler = scmi_base_vendor_handler,
+	},
+	[SCMI_BASE_DISCOVER_SUB_VENDOR] = {
+		.handler = scmi_base_sub_vendor_handler,
+	},
+	[SCMI_BASE_DISCOVER_IMPLEMENTATION_VERSION] = {
+		.handler = scmi_base_impl_version_handler,
+	},
+	[SCMI_BASE_DISCOVER_LIST_PROTOCOLS] = {
+		.handler = scmi_base_list_protocols_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+};
+
+/*
+ * Power domain protocol: PROTOCOL_ATTRIBUTES.
+ *
+ * The power domains are the CPU clusters. They are only reported, since
+ * CPU power state changes must go through PSCI.
+ */
+static int
+scmi_power_attributes_handler(const uint32_t *rx_payload UNUSED,
+                              uint32_t *tx_payload, uint16_t *tx_size)
+{
+	/* There is no statistics shared memory region. */
+	tx_payload[0] = css_get_cluster_count();
+	tx_payload[1] = 0;
+	tx_payload[2] = 0;
+	tx_payload[3] = 0;
+	*tx_size      = 4 * sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Power domain protocol: POWER_DOMAIN_ATTRIBUTES.
+ */
+static int
+scmi_power_domain_attributes_handler(const uint32_t *rx_payload,
+                                     uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t domain = rx_payload[0];
+
+	if (domain >= css_get_cluster_count())
+		return SCMI_NOT_FOUND;
+
+	/* Neither notifications nor state changes are supported. */
+	tx_payload[0] = 0;
+	scmi_put_cluster_name(&tx_payload[1], domain);
+	*tx_size = sizeof(uint32_t) + SCMI_NAME_SIZE;
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Power domain protocol: POWER_STATE_SET.
+ */
+static int
+scmi_power_state_set_handler(const uint32_t *rx_payload UNUSED,
+                             uint32_t *tx_payload UNUSED,
+                             uint16_t *tx_size UNUSED)
+{
+	/* Prevent Linux from changing power states behind PSCI. */
+	return SCMI_DENIED;
+}
+
+/*
+ * Power domain protocol: POWER_STATE_GET.
+ */
+static int
+scmi_power_state_get_handler(const uint32_t *rx_payload,
+                             uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t domain = rx_payload[0];
+	uint32_t state, online_cores;
+
+	if (css_get_power_state(domain, &state, &online_cores))
+		return SCMI_NOT_FOUND;
+
+	/* Bit 30 means the domain loses context (it is off). */
+	tx_payload[0] = state == SCPI_CSS_OFF ? BIT(30) : state;
+	*tx_size      = sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+static const struct scmi_cmd scmi_power_cmds[] = {
+	[SCMI_PROTOCOL_ATTRIBUTES] = {
+		.handler = scmi_power_attributes_handler,
+	},
+	[SCMI_POWER_DOMAIN_ATTRIBUTES] = {
+		.handler = scmi_power_domain_attributes_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+	[SCMI_POWER_STATE_SET] = {
+		.handler = scmi_power_state_set_handler,
+		.rx_size = 3 * sizeof(uint32_t),
+	},
+	[SCMI_POWER_STATE_GET] = {
+		.handler = scmi_power_state_get_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+};
+
+/*
+ * System power protocol: PROTOCOL_ATTRIBUTES.
+ */
+static int
+scmi_system_attributes_handler(const uint32_t *rx_payload UNUSED,
+                               uint32_t *tx_payload, uint16_t *tx_size)
+{
+	tx_payload[0] = 0;
+	*tx_size      = sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * System power protocol: SYSTEM_POWER_STATE_SET.
+ */
+static int
+scmi_system_state_set_handler(const uint32_t *rx_payload UNUSED,
+                              uint32_t *tx_payload UNUSED,
+                              uint16_t *tx_size UNUSED)
+{
+	/* Prevent Linux from changing power states behind PSCI. */
+	return SCMI_DENIED;
+}
+
+static const struct scmi_cmd scmi_system_cmds[] = {
+	[SCMI_PROTOCOL_ATTRIBUTES] = {
+		.handler = scmi_system_attributes_handler,
+	},
+	[SCMI_SYSTEM_POWER_STATE_SET] = {
+		.handler = scmi_system_state_set_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+};
+
+#if CONFIG(DVFS)
+/*
+ * Get the effective performance limits of a domain, in kHz.
+ */
+static void
+scmi_perf_get_limits(uint32_t domain, const struct css_opp *opps,
+                     uint32_t count, uint32_t *min, uint32_t *max)
+{
+	*min = scmi_perf_min[domain];
+	if (!*min)
+		*min = opps[0].rate / 1000;
+	*max = scmi_perf_max[domain];
+	if (!*max)
+		*max = opps[count - 1].rate / 1000;
+}
+
+/*
+ * Performance protocol: PROTOCOL_ATTRIBUTES.
+ */
+static int
+scmi_perf_attributes_handler(const uint32_t *rx_payload UNUSED,
+                             uint32_t *tx_payload, uint16_t *tx_size)
+{
+	/* There is no statistics shared memory region. */
+	tx_payload[0] = css_get_dvfs_count();
+	tx_payload[1] = 0;
+	tx_payload[2] = 0;
+	tx_payload[3] = 0;
+	*tx_size      = 4 * sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Performance protocol: PERF_DOMAIN_ATTRIBUTES.
+ *
+ * Performance levels are expressed as CPU clock rates in kHz.
+ */
+static int
+scmi_perf_domain_attributes_handler(const uint32_t *rx_payload,
+                                    uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t domain = rx_payload[0];
+	const struct css_opp *opps;
+	uint32_t count, latency;
+
+	if (css_get_opps(domain, &opps, &count, &latency))
+		return SCMI_NOT_FOUND;
+
+	/* Limits and levels can be set; there are no notifications. */
+	tx_payload[0] = BIT(31) | BIT(30);
+	tx_payload[1] = latency;
+	tx_payload[2] = opps[count - 1].rate / 1000;
+	tx_payload[3] = opps[count - 1].rate / 1000;
+	scmi_put_cluster_name(&tx_payload[4], domain);
+	*tx_size = 4 * sizeof(uint32_t) + SCMI_NAME_SIZE;
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Performance protocol: PERF_DESCRIBE_LEVELS.
+ */
+static int
+scmi_perf_describe_levels_handler(const uint32_t *rx_payload,
+                                  uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t domain = rx_payload[0];
+	uint32_t index  = rx_payload[1];
+	const struct css_opp *opps;
+	uint32_t count, latency, n;
+
+	if (css_get_opps(domain, &opps, &count, &latency))
+		return SCMI_NOT_FOUND;
+	if (index > count)
+		return SCMI_INVALID_PARAMETERS;
+
+	n = count - index;
+	if (n > PERF_MAX_LEVELS)
+		n = PERF_MAX_LEVELS;
+	tx_payload[0] = n | (count - index - n) << 16;
+	for (uint32_t i = 0; i < n; ++i) {
+		/* The power cost is unknown. */
+		tx_payload[1 + 3 * i] = opps[index + i].rate / 1000;
+		tx_payload[2 + 3 * i] = 0;
+		tx_payload[3 + 3 * i] = latency;
+	}
+	*tx_size = sizeof(uint32_t) * (1 + 3 * n);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Performance protocol: PERF_LIMITS_SET.
+ *
+ * If the current level is outside the new limits, the fastest level within
+ * the limits is selected.
+ */
+static int
+scmi_perf_limits_set_handler(const uint32_t *rx_payload,
+                             uint32_t *tx_payload UNUSED,
+                             uint16_t *tx_size UNUSED)
+{
+	uint32_t domain = rx_payload[0];
+	uint32_t max    = rx_payload[1];
+	uint32_t min    = rx_payload[2];
+	const struct css_opp *opps;
+	uint32_t count, latency, opp, level;
+	uint32_t target = UINT32_MAX;
+
+	if (css_get_opps(domain, &opps, &count, &latency))
+		return SCMI_NOT_FOUND;
+	if (min > max)
+		return SCMI_INVALID_PARAMETERS;
+
+	for (uint32_t i = 0; i < count; ++i) {
+		level = opps[i].rate / 1000;
+		if (level >= min && level <= max)
+			target = i;
+	}
+	if (target == UINT32_MAX)
+		return SCMI_OUT_OF_RANGE;
+
+	scmi_perf_min[domain] = min;
+	scmi_perf_max[domain] = max;
+
+	if (css_get_opp(domain, &opp))
+		return SCMI_HARDWARE_ERROR;
+	level = opps[opp].rate / 1000;
+	if ((level < min || level > max) && css_set_opp(domain, target))
+		return SCMI_HARDWARE_ERROR;
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Performance protocol: PERF_LIMITS_GET.
+ */
+static int
+scmi_perf_limits_get_handler(const uint32_t *rx_payload,
+                             uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t domain = rx_payload[0];
+	const struct css_opp *opps;
+	uint32_t count, latency;
+
+	if (css_get_opps(domain, &opps, &count, &latency))
+		return SCMI_NOT_FOUND;
+
+	scmi_perf_get_limits(domain, opps, count,
+	                     &tx_payload[1], &tx_payload[0]);
+	*tx_size = 2 * sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Performance protocol: PERF_LEVEL_SET.
+ */
+static int
+scmi_perf_level_set_handler(const uint32_t *rx_payload,
+                            uint32_t *tx_payload UNUSED,
+                            uint16_t *tx_size UNUSED)
+{
+	uint32_t domain = rx_payload[0];
+	uint32_t level  = rx_payload[1];
+	const struct css_opp *opps;
+	uint32_t count, latency, min, max;
+
+	if (css_get_opps(domain, &opps, &count, &latency))
+		return SCMI_NOT_FOUND;
+
+	scmi_perf_get_limits(domain, opps, count, &min, &max);
+	if (level < min || level > max)
+		return SCMI_OUT_OF_RANGE;
+
+	for (uint32_t i = 0; i < count; ++i) {
+		if (opps[i].rate / 1000 != level)
+			continue;
+		if (css_set_opp(domain, i))
+			return SCMI_HARDWARE_ERROR;
+		return SCMI_SUCCESS;
+	}
+
+	return SCMI_OUT_OF_RANGE;
+}
+
+/*
+ * Performance protocol: PERF_LEVEL_GET.
+ */
+static int
+scmi_perf_level_get_handler(const uint32_t *rx_payload,
+                            uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t domain = rx_payload[0];
+	const struct css_opp *opps;
+	uint32_t count, latency, opp;
+
+	if (css_get_opps(domain, &opps, &count, &latency))
+		return SCMI_NOT_FOUND;
+	if (css_get_opp(domain, &opp))
+		return SCMI_HARDWARE_ERROR;
+
+	tx_payload[0] = opps[opp].rate / 1000;
+	*tx_size      = sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+static const struct scmi_cmd scmi_perf_cmds[] = {
+	[SCMI_PROTOCOL_ATTRIBUTES] = {
+		.handler = scmi_perf_attributes_handler,
+	},
+	[SCMI_PERF_DOMAIN_ATTRIBUTES] = {
+		.handler = scmi_perf_domain_attributes_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+	[SCMI_PERF_DESCRIBE_LEVELS] = {
+		.handler = scmi_perf_describe_levels_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+	[SCMI_PERF_LIMITS_SET] = {
+		.handler = scmi_perf_limits_set_handler,
+		.rx_size = 3 * sizeof(uint32_t),
+	},
+	[SCMI_PERF_LIMITS_GET] = {
+		.handler = scmi_perf_limits_get_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+	[SCMI_PERF_LEVEL_SET] = {
+		.handler = scmi_perf_level_set_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+	[SCMI_PERF_LEVEL_GET] = {
+		.handler = scmi_perf_level_get_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+};
+#endif
+
+#if CONFIG(CLOCK_SERVICE)
+
+/*
+ * Clock protocol: PROTOCOL_ATTRIBUTES.
+ */
+static int
+scmi_clock_attributes_handler(const uint32_t *rx_payload UNUSED,
+                              uint32_t *tx_payload, uint16_t *tx_size)
+{
+	/* One asynchronous rate change may be pending at a time. */
+	tx_payload[0] = scpi_clock_count | 1 << 16;
+	*tx_size      = sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Clock protocol: CLOCK_ATTRIBUTES.
+ */
+static int
+scmi_clock_clock_attributes_handler(const uint32_t *rx_payload,
+                                    uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id = rx_payload[0];
+	const struct scpi_clock *clock;
+
+	if (id >= scpi_clock_count)
+		return SCMI_NOT_FOUND;
+
+	clock = &scpi_clocks[id];
+	tx_payload[0] = clock_get_state(&clock->clock) == CLOCK_STATE_ENABLED;
+	scmi_put_name(&tx_payload[1], clock->name);
+	*tx_size = sizeof(uint32_t) + SCMI_NAME_SIZE;
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Clock protocol: CLOCK_DESCRIBE_RATES.
+ *
+ * Writable clocks report their range of rates; other clocks only report
+ * their current rate.
+ */
+static int
+scmi_clock_describe_rates_handler(const uint32_t *rx_payload,
+                                  uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id    = rx_payload[0];
+	uint32_t index = rx_payload[1];
+	const struct clock_handle *clock;
+
+	if (id >= scpi_clock_count)
+		return SCMI_NOT_FOUND;
+
+	clock = &scpi_clocks[id].clock;
+	if (scpi_clocks[id].flags & SCPI_FLAG_WRITABLE) {
+		/* Return a {min, max, step} triplet of 64-bit rates. */
+		tx_payload[0] = 3 | BIT(12);
+		tx_payload[1] = clock_round_rate(clock, 0);
+		tx_payload[2] = 0;
+		tx_payload[3] = clock_round_rate(clock, UINT32_MAX);
+		tx_payload[4] = 0;
+		tx_payload[5] = 1;
+		tx_payload[6] = 0;
+		*tx_size      = 7 * sizeof(uint32_t);
+	} else if (index == 0) {
+		tx_payload[0] = 1;
+		tx_payload[1] = clock_get_rate(clock);
+		tx_payload[2] = 0;
+		*tx_size      = 3 * sizeof(uint32_t);
+	} else {
+		tx_payload[0] = 0;
+		*tx_size      = sizeof(uint32_t);
+	}
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Clock protocol: CLOCK_RATE_SET.
+ *
+ * Rate changes finish quickly, so asynchronous requests are completed before
+ * the response is sent, and the delayed response is queued immediately.
+ */
+static int
+scmi_clock_rate_set_handler(const uint32_t *rx_payload,
+                            uint32_t *tx_payload UNUSED,
+                            uint16_t *tx_size UNUSED)
+{
+	uint32_t flags = rx_payload[0];
+	uint32_t id    = rx_payload[1];
+	const struct clock_handle *clock;
+	uint32_t payload[4];
+
+	if (id >= scpi_clock_count)
+		return SCMI_NOT_FOUND;
+	if (!(scpi_clocks[id].flags & SCPI_FLAG_WRITABLE))
+		return SCMI_DENIED;
+	if (rx_payload[3])
+		return SCMI_OUT_OF_RANGE;
+
+	/* Do not change the rate underneath a firmware driver. */
+	clock = &scpi_clocks[id].clock;
+	if (clock_active(clock) && !(scmi_clocks_held & BIT(id)))
+		return SCMI_DENIED;
+	if (clock_set_rate(clock, rx_payload[2]))
+		return SCMI_HARDWARE_ERROR;
+
+	/* Bit 0 requests an asynchronous change; bit 1 skips the delayed
+	 * response. */
+	if ((flags & (BIT(0) | BIT(1))) != BIT(0))
+		return SCMI_SUCCESS;
+
+	payload[0] = SCMI_SUCCESS;
+	payload[1] = id;
+	payload[2] = clock_get_rate(clock);
+	payload[3] = 0;
+
+	return scmi_delayed_response(SCMI_PROTOCOL_CLOCK, SCMI_CLOCK_RATE_SET,
+	                             payload, sizeof(payload));
+}
+
+/*
+ * Clock protocol: CLOCK_RATE_GET.
+ */
+static int
+scmi_clock_rate_get_handler(const uint32_t *rx_payload,
+                            uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id = rx_payload[0];
+
+	if (id >= scpi_clock_count)
+		return SCMI_NOT_FOUND;
+	if (!(scpi_clocks[id].flags & SCPI_FLAG_READABLE))
+		return SCMI_DENIED;
+
+	tx_payload[0] = clock_get_rate(&scpi_clocks[id].clock);
+	tx_payload[1] = 0;
+	*tx_size      = 2 * sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Clock protocol: CLOCK_CONFIG_SET.
+ *
+ * Read-only clocks are always running, so they can only be "enabled".
+ *
+ * The first change takes a reference to the clock on behalf of the agent,
+ * which is kept from then on, so later changes only toggle the gate and never
+ * assert the reset. Clocks used only by a firmware driver cannot be changed.
+ */
+static int
+scmi_clock_config_set_handler(const uint32_t *rx_payload,
+                              uint32_t *tx_payload UNUSED,
+                              uint16_t *tx_size UNUSED)
+{
+	uint32_t id     = rx_payload[0];
+	bool     enable = rx_payload[1] & BIT(0);
+	const struct clock_handle *clock;
+
+	if (id >= scpi_clock_count)
+		return SCMI_NOT_FOUND;
+
+	clock = &scpi_clocks[id].clock;
+	if (!(scpi_clocks[id].flags & SCPI_FLAG_WRITABLE))
+		return enable ? SCMI_SUCCESS : SCMI_DENIED;
+
+	if (!(scmi_clocks_held & BIT(id))) {
+		if (clock_active(clock))
+			return SCMI_DENIED;
+		if (clock_get(clock))
+			return SCMI_HARDWARE_ERROR;
+		scmi_clocks_held |= BIT(id);
+	}
+
+	if (enable)
+		clock_enable(clock);
+	else
+		clock_disable(clock);
+
+	return SCMI_SUCCESS;
+}
+
+static const struct scmi_cmd scmi_clock_cmds[] = {
+	[SCMI_PROTOCOL_ATTRIBUTES] = {
+		.handler = scmi_clock_attributes_handler,
+	},
+	[SCMI_CLOCK_ATTRIBUTES] = {
+		.handler = scmi_clock_clock_attributes_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+	[SCMI_CLOCK_DESCRIBE_RATES] = {
+		.handler = scmi_clock_describe_rates_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+	[SCMI_CLOCK_RATE_SET] = {
+		.handler = scmi_clock_rate_set_handler,
+		.rx_size = 4 * sizeof(uint32_t),
+	},
+	[SCMI_CLOCK_RATE_GET] = {
+		.handler = scmi_clock_rate_get_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+	[SCMI_CLOCK_CONFIG_SET] = {
+		.handler = scmi_clock_config_set_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+};
+#endif
+
+/*
+ * Sensor protocol: PROTOCOL_ATTRIBUTES.
+ */
+static int
+scmi_sensor_attributes_handler(const uint32_t *rx_payload UNUSED,
+                               uint32_t *tx_payload, uint16_t *tx_size)
+{
+	/* One asynchronous read may be pending at a time. There is no
+	 * sensor register shared memory region. */
+	tx_payload[0] = scpi_sensor_count | 1 << 16;
+	tx_payload[1] = 0;
+	tx_payload[2] = 0;
+	tx_payload[3] = 0;
+	*tx_size      = 4 * sizeof(uint32_t);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Sensor protocol: SENSOR_DESCRIPTION_GET.
+ */
+static int
+scmi_sensor_description_get_handler(const uint32_t *rx_payload,
+                                    uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t index = rx_payload[0];
+	uint32_t n;
+
+	if (index > scpi_sensor_count)
+		return SCMI_INVALID_PARAMETERS;
+
+	n = scpi_sensor_count - index;
+	if (n > SENSOR_MAX_DESCS)
+		n = SENSOR_MAX_DESCS;
+	tx_payload[0] = n | (scpi_sensor_count - index - n) << 16;
+	for (uint32_t i = 0; i < n; ++i) {
+		uint32_t  id   = index + i;
+		uint32_t *desc = &tx_payload[1 + 7 * i];
+
+		/* Asynchronous reads are supported, and sensors with trip
+		 * point state have one trip point. */
+		desc[0] = id;
+		desc[1] = BIT(31) | (id < SENSOR_MAX_TRIPS);
+		desc[2] = SENSOR_TYPE_MILLIDEGREES_C;
+		scmi_put_name(&desc[3], scpi_sensors[id].name);
+	}
+	*tx_size = sizeof(uint32_t) * (1 + 7 * n);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Sensor protocol: SENSOR_TRIP_POINT_NOTIFY.
+ */
+static int
+scmi_sensor_trip_notify_handler(const uint32_t *rx_payload,
+                                uint32_t *tx_payload UNUSED,
+                                uint16_t *tx_size UNUSED)
+{
+	uint32_t id = rx_payload[0];
+
+	if (id >= scpi_sensor_count)
+		return SCMI_NOT_FOUND;
+	if (id >= SENSOR_MAX_TRIPS)
+		return SCMI_NOT_SUPPORTED;
+
+	scmi_sensor_trips[id].notify = rx_payload[1] & BIT(0);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Arm the sensor bounds so the next crossing of the trip point in an enabled
+ * direction raises an event.
+ */
+static void
+scmi_sensor_arm_trip(uint8_t id, bool ascending)
+{
+	const struct scmi_sensor_trip *trip = &scmi_sensor_trips[id];
+
+	if (trip->mode == TRIP_DISABLED)
+		sensor_list_set_bounds(id, 0, UINT32_MAX);
+	else if (ascending)
+		sensor_list_set_bounds(id, 0, trip->value);
+	else
+		sensor_list_set_bounds(id, trip->value, UINT32_MAX);
+}
+
+/*
+ * Sensor protocol: SENSOR_TRIP_POINT_CONFIG.
+ */
+static int
+scmi_sensor_trip_config_handler(const uint32_t *rx_payload,
+                                uint32_t *tx_payload UNUSED,
+                                uint16_t *tx_size UNUSED)
+{
+	uint32_t id      = rx_payload[0];
+	uint32_t control = rx_payload[1];
+	struct scmi_sensor_trip *trip;
+	uint32_t value;
+
+	if (id >= scpi_sensor_count)
+		return SCMI_NOT_FOUND;
+	if (id >= SENSOR_MAX_TRIPS || bitfield_get(control, 4, 8))
+		return SCMI_INVALID_PARAMETERS;
+	if (rx_payload[3])
+		return SCMI_OUT_OF_RANGE;
+
+	trip        = &scmi_sensor_trips[id];
+	trip->mode  = bitfield_get(control, 0, 2);
+	trip->value = rx_payload[2];
+
+	/* When watching both directions, look for the next crossing away
+	 * from the current value. */
+	if (trip->mode == TRIP_BOTH && !sensor_list_get_value(id, &value))
+		scmi_sensor_arm_trip(id, value <= trip->value);
+	else
+		scmi_sensor_arm_trip(id, trip->mode != TRIP_DESCENDING);
+
+	return SCMI_SUCCESS;
+}
+
+/*
+ * Sensor protocol: SENSOR_READING_GET.
+ *
+ * Sensor values are cached, so asynchronous reads are completed before the
+ * response is sent, and the delayed response is queued immediately.
+ */
+static int
+scmi_sensor_reading_get_handler(const uint32_t *rx_payload,
+                                uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id = rx_payload[0];
+	uint32_t payload[4];
+	uint32_t value;
+	int err;
+
+	if (id >= scpi_sensor_count)
+		return SCMI_NOT_FOUND;
+
+	if ((err = sensor_list_get_value(id, &value)))
+		return err == EBUSY ? SCMI_BUSY : SCMI_HARDWARE_ERROR;
+
+	if (!(rx_payload[1] & BIT(0))) {
+		tx_payload[0] = value;
+		tx_payload[1] = 0;
+		*tx_size      = 2 * sizeof(uint32_t);
+
+		return SCMI_SUCCESS;
+	}
+
+	payload[0] = SCMI_SUCCESS;
+	payload[1] = id;
+	payload[2] = value;
+	payload[3] = 0;
+
+	return scmi_delayed_response(SCMI_PROTOCOL_SENSOR,
+	                             SCMI_SENSOR_READING_GET,
+	                             payload, sizeof(payload));
+}
+
+static const struct scmi_cmd scmi_sensor_cmds[] = {
+	[SCMI_PROTOCOL_ATTRIBUTES] = {
+		.handler = scmi_sensor_attributes_handler,
+	},
+	[SCMI_SENSOR_DESCRIPTION_GET] = {
+		.handler = scmi_sensor_description_get_handler,
+		.rx_size = sizeof(uint32_t),
+	},
+	[SCMI_SENSOR_TRIP_POINT_NOTIFY] = {
+		.handler = scmi_sensor_trip_notify_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+	[SCMI_SENSOR_TRIP_POINT_CONFIG] = {
+		.handler = scmi_sensor_trip_config_handler,
+		.rx_size = 4 * sizeof(uint32_t),
+	},
+	[SCMI_SENSOR_READING_GET] = {
+		.handler = scmi_sensor_reading_get_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+};
+
+#define PROTOCOL(_id, _cmds, major, minor) { \
+		.cmds      = (_cmds), \
+		.version   = SCMI_VERSION(major, minor), \
+		.id        = (_id), \
+		.cmd_count = ARRAY_SIZE(_cmds), \
+	}
+
+/*
+ * The list of supported SCMI protocols.
+ */
+static const struct scmi_protocol scmi_protocols[] = {
+	PROTOCOL(SCMI_PROTOCOL_BASE,   scmi_base_cmds,   2, 0),
+	PROTOCOL(SCMI_PROTOCOL_POWER,  scmi_power_cmds,  2, 0),
+	PROTOCOL(SCMI_PROTOCOL_SYSTEM, scmi_system_cmds, 1, 0),
+#if CONFIG(DVFS)
+	PROTOCOL(SCMI_PROTOCOL_PERF,   scmi_perf_cmds,   2, 0),
+#endif
+#if CONFIG(CLOCK_SERVICE)
+	PROTOCOL(SCMI_PROTOCOL_CLOCK,  scmi_clock_cmds,  1, 0),
+#endif
+	PROTOCOL(SCMI_PROTOCOL_SENSOR, scmi_sensor_cmds, 1, 0),
+};
+
+/*
+ * Look up a command handler.
+ */
+static const struct scmi_cmd *
+scmi_get_cmd(const struct scmi_protocol *protocol, uint32_t message)
+{
+	if (message >= protocol->cmd_count)
+		return NULL;
+	if (!protocol->cmds[message].handler)
+		return NULL;
+
+	return &protocol->cmds[message];
+}
+
+/*
+ * Generic SCMI command handling function.
+ */
+void
+scmi_handle_cmd(struct scmi_shmem *shmem)
+{
+	uint32_t header  = shmem->header;
+	uint32_t message = bitfield_get(header, 0, 8);
+	uint32_t type    = bitfield_get(header, 8, 2);
+	uint32_t id      = bitfield_get(header, 10, 8);
+	uint32_t rx_payload[SCMI_RX_WORDS];
+	const struct scmi_protocol *protocol = NULL;
+	const struct scmi_cmd *cmd;
+	uint32_t *tx_payload = &shmem->payload[1];
+	uint32_t rx_size;
+	uint16_t tx_size = 0;
+	int status;
+
+	scmi_token = bitfield_get(header, 18, 10);
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(scmi_protocols); ++i) {
+		if (scmi_protocols[i].id == id)
+			protocol = &scmi_protocols[i];
+	}
+
+	/* The length includes the message header. */
+	rx_size = shmem->length - sizeof(header);
+	if (shmem->length < sizeof(header) || rx_size > sizeof(rx_payload))
+		rx_size = UINT32_MAX;
+
+	/* The response overwrites the command, so copy the command first. */
+	for (uint32_t i = 0; i < SCMI_RX_WORDS; ++i)
+		rx_payload[i] = shmem->payload[i];
+
+	if (!protocol || type != SCMI_TYPE_COMMAND) {
+		status = SCMI_NOT_SUPPORTED;
+	} else if (message == SCMI_PROTOCOL_VERSION) {
+		tx_payload[0] = protocol->version;
+		tx_size       = sizeof(uint32_t);
+		status        = SCMI_SUCCESS;
+	} else if (message == SCMI_PROTOCOL_MESSAGE_ATTRIBUTES) {
+		/* No message has any special attributes. */
+		message = rx_payload[0];
+		status  = message == SCMI_PROTOCOL_VERSION ||
+		          message == SCMI_PROTOCOL_MESSAGE_ATTRIBUTES ||
+		          scmi_get_cmd(protocol, message) ? SCMI_SUCCESS
+		                                          : SCMI_NOT_FOUND;
+		tx_payload[0] = 0;
+		tx_size       = sizeof(uint32_t);
+	} else if (!(cmd = scmi_get_cmd(protocol, message))) {
+		status = SCMI_NOT_SUPPORTED;
+	} else if (rx_size != cmd->rx_size) {
+		status = SCMI_PROTOCOL_ERROR;
+	} else {
+		status = cmd->handler(rx_payload, tx_payload, &tx_size);
+	}
+
+	if (status != SCMI_SUCCESS)
+		tx_size = 0;
+
+	/* The response reuses the command's message header. */
+	shmem->payload[0] = status;
+	shmem->length     = sizeof(header) + sizeof(uint32_t) + tx_size;
+}
+
+void
+scmi_sensor_event(uint8_t id, uint32_t value)
+{
+	const struct scmi_sensor_trip *trip;
+	bool ascending;
+	uint32_t payload[3];
+
+	if (id >= SENSOR_MAX_TRIPS)
+		return;
+
+	trip      = &scmi_sensor_trips[id];
+	ascending = value > trip->value;
+
+	/* Watch for the crossing back in the other direction. */
+	if (trip->mode == TRIP_BOTH)
+		scmi_sensor_arm_trip(id, !ascending);
+
+	if (!trip->notify || trip->mode == TRIP_DISABLED)
+		return;
+
+	payload[0] = SCMI_AGENT_ID;
+	payload[1] = id;
+	payload[2] = ascending << 16;
+
+	scmi_create_message(SCMI_HEADER(SCMI_PROTOCOL_SENSOR,
+	                                SCMI_SENSOR_TRIP_POINT_EVENT,
+	                                SCMI_TYPE_NOTIFICATION, 0),
+	                    payload, sizeof(payload));
+}
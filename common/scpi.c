@@ -5,23 +5,37 @@
 
 #include <debug.h>
 #include <error.h>
+#include <intrusive.h>
 #include <msgbox.h>
 #include <scpi.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <timeout.h>
+#include <timer.h>
 
 #define SCPI_MEM_AREA(n) (__scpi_mem[SCPI_CLIENTS - n - 1])
 
 #define SCPI_TX_TIMEOUT  (10 * USEC_PER_MSEC) /* 10ms */
 
+#define SCPI_QUEUE_SIZE  4
+
 #define RX_CHAN(client)  (2 * (client))
 #define TX_CHAN(client)  (2 * (client) + 1)
 
+struct scpi_queued_msg {
+	uint32_t payload[SCPI_QUEUED_PAYLOAD_WORDS];
+	uint8_t  command;
+	uint8_t  size;
+};
+
 struct scpi_state {
-	uint32_t timeout;
-	bool     tx_full;
+	struct timer           timeout;
+	struct scpi_queued_msg queue[SCPI_QUEUE_SIZE];
+	uint8_t                queue_head;
+	uint8_t                queue_len;
+	bool                   rx_deferred;
+	bool                   tx_full;
 };
 
 /** The shared memory area, with an address defined in the linker script. */
@@ -31,7 +45,19 @@ extern struct scpi_mem __scpi_mem[SCPI_CLIENTS];
 static struct scpi_state scpi_state[SCPI_CLIENTS];
 
 /**
- * Send an SCPI message to the client, recording the timeout for when the
+ * Free the TX buffer if the client fails to acknowledge a message in time.
+ */
+static void
+scpi_tx_timeout(struct timer *timer)
+{
+	struct scpi_state *state =
+		container_of(timer, struct scpi_state, timeout);
+
+	state->tx_full = false;
+}
+
+/**
+ * Send an SCPI message to the client, starting the timer for when the
  * client must acknowledge the message.
  */
 static void
@@ -43,8 +69,8 @@ scpi_send_message(const struct device *mailbox, uint8_t client,
 	/* Ensure the outgoing message is fully written at this point. */
 	barrier();
 
-	/* Ensure the timeout is updated before triggering transmission. */
-	state->timeout = timeout_set(SCPI_TX_TIMEOUT);
+	/* Ensure the timer is started before triggering transmission. */
+	timer_start(&state->timeout, scpi_tx_timeout, SCPI_TX_TIMEOUT, false);
 	state->tx_full = true;
 	barrier();
 
@@ -54,24 +80,61 @@ scpi_send_message(const struct device *mailbox, uint8_t client,
 		warn("SCPI%u: Send error: %d", client, err);
 }
 
-void
-scpi_create_message(const struct device *mailbox, uint8_t client,
-                    uint8_t command)
+/**
+ * Move the oldest queued message for a client to its TX buffer.
+ *
+ * @return If a message was moved and should be sent to the client.
+ */
+static bool
+scpi_dequeue_message(uint8_t client, struct scpi_state *state)
 {
-	struct scpi_mem *mem     = &SCPI_MEM_AREA(client);
-	struct scpi_state *state = &scpi_state[client];
+	struct scpi_mem *mem = &SCPI_MEM_AREA(client);
+	struct scpi_queued_msg *msg;
+
+	if (!state->queue_len)
+		return false;
 
-	if (state->tx_full)
-		return;
+	msg = &state->queue[state->queue_head];
+	state->queue_head = (state->queue_head + 1) % SCPI_QUEUE_SIZE;
+	state->queue_len--;
 
 	/* Write the message header. */
-	mem->tx_msg.command = command;
+	mem->tx_msg.command = msg->command;
 	mem->tx_msg.sender  = SCPI_SENDER_SCP;
-	mem->tx_msg.size    = 0;
+	mem->tx_msg.size    = msg->size;
 	mem->tx_msg.status  = SCPI_OK;
 
-	/* Send the message. */
-	scpi_send_message(mailbox, client, state);
+	/* Write the message payload. */
+	for (uint8_t i = 0; i < SCPI_QUEUED_PAYLOAD_WORDS; ++i)
+		mem->tx_msg.payload[i] = msg->payload[i];
+
+	return true;
+}
+
+int
+scpi_create_message(uint8_t client, uint8_t command,
+                    const uint32_t *payload, uint8_t size)
+{
+	struct scpi_state *state = &scpi_state[client];
+	struct scpi_queued_msg *msg;
+	uint8_t tail;
+
+	assert(size <= sizeof(msg->payload));
+
+	if (state->queue_len == SCPI_QUEUE_SIZE) {
+		warn("SCPI%u: Dropped message %u", client, command);
+		return EBUSY;
+	}
+
+	tail = (state->queue_head + state->queue_len) % SCPI_QUEUE_SIZE;
+	msg  = &state->queue[tail];
+	msg->command = command;
+	msg->size    = size;
+	for (uint8_t i = 0; i < SCPI_QUEUED_PAYLOAD_WORDS; ++i)
+		msg->payload[i] = 4 * i < size ? payload[i] : 0;
+	state->queue_len++;
+
+	return SUCCESS;
 }
 
 /**
@@ -82,7 +145,7 @@ scpi_create_message(const struct device *mailbox, uint8_t client,
  * command. The functions for doing so are defined in a separate file to
  * separate the API functionality from communication/state management code.
  */
-static void
+static bool
 scpi_poll_one_client(const struct device *mailbox, uint8_t client)
 {
 	struct scpi_state *state = &scpi_state[client];
@@ -91,44 +154,65 @@ scpi_poll_one_client(const struct device *mailbox, uint8_t client)
 
 	/* Flush any outgoing messages. The TX buffer becomes free when a
 	 * previously-sent message is acknowledged or when it times out. */
-	if (state->tx_full) {
-		if (msgbox_last_tx_done(mailbox, tx_chan) ||
-		    timeout_expired(state->timeout))
-			state->tx_full = false;
+	if (state->tx_full && msgbox_last_tx_done(mailbox, tx_chan)) {
+		timer_stop(&state->timeout);
+		state->tx_full = false;
 	}
 
 	/* Once the TX buffer is free, we can process new messages, reading
 	 * from the RX buffer and generating responses in the TX buffer. */
 	if (!state->tx_full) {
-		bool reply_needed = false;
+		struct scpi_mem *mem = &SCPI_MEM_AREA(client);
+		uint8_t result = SCPI_HANDLED;
+		bool received  = false;
 		uint32_t msg;
 
-		/* Try to grab a new message. All errors are handled by
-		 * retrying on the next iteration through the main loop. */
-		if (msgbox_receive(mailbox, rx_chan, &msg) == SUCCESS) {
+		/* Retry a deferred command, or try to grab a new message.
+		 * All errors are handled by retrying on the next iteration
+		 * through the main loop. */
+		if (state->rx_deferred) {
+			result   = scpi_handle_cmd(client, mem);
+			received = true;
+		} else if (msgbox_receive(mailbox, rx_chan, &msg) == SUCCESS) {
 			/* Only process messages sent with the correct
 			 * protocol, which SCPI calls a "virtual channel". */
-			if (msg == SCPI_VIRTUAL_CHANNEL) {
-				struct scpi_mem *mem = &SCPI_MEM_AREA(client);
-
-				/* The handler relays if a reply is needed. */
-				reply_needed = scpi_handle_cmd(client, mem);
-			}
+			if (msg == SCPI_VIRTUAL_CHANNEL)
+				result = scpi_handle_cmd(client, mem);
+			received = true;
+		}
 
-			/* Acknowledging the message allows the client to reuse
-			 * the RX buffer, so the handler must run first. */
+		/* Acknowledging the message allows the client to reuse
+		 * the RX buffer, so the handler must finish first. */
+		state->rx_deferred = result == SCPI_DEFERRED;
+		if (received && !state->rx_deferred)
 			msgbox_ack_rx(mailbox, rx_chan);
-		}
+
+		/* Otherwise, use the free TX buffer for a queued message. */
+		if (result != SCPI_REPLY &&
+		    scpi_dequeue_message(client, state))
+			result = SCPI_REPLY;
 
 		/* If the TX buffer now contains a reply, send it. */
-		if (reply_needed)
+		if (result == SCPI_REPLY)
 			scpi_send_message(mailbox, client, state);
 	}
+
+	/* Acknowledgements do not generate an IRQ, so they must be polled.
+	 * Deferred commands must be retried without waiting for an IRQ. */
+	return state->tx_full || state->rx_deferred;
 }
 
-void
+bool
 scpi_poll(const struct device *mailbox)
 {
-	for (uint8_t client = 0; client < SCPI_CLIENTS; ++client)
-		scpi_poll_one_client(mailbox, client);
+	bool busy = false;
+
+	for (uint8_t client = 0; client < SCPI_CLIENTS; ++client) {
+		/* SCMI takes over the non-secure client's channels. */
+		if (CONFIG(SCMI) && client == SCPI_CLIENT_EL2)
+			continue;
+		busy |= scpi_poll_one_client(mailbox, client);
+	}
+
+	return busy;
 }
@@ -4,10 +4,15 @@
  */
 
 #include <bitfield.h>
+#include <clock.h>
+#include <clock_list.h>
 #include <css.h>
 #include <debug.h>
 #include <device.h>
+#include <error.h>
+#include <regulator_list.h>
 #include <scpi.h>
+#include <sensor_list.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -22,6 +27,13 @@ enum {
 	FLAG_SECURE_ONLY = BIT(1),
 };
 
+/**
+ * Returned by a handler that cannot finish yet without waiting. The handler
+ * will be called again with the same message from a later iteration of the
+ * main loop, so it must not have side effects before returning this value.
+ */
+#define SCPI_PENDING (-1)
+
 struct scpi_cmd {
 	/** Handler that can process a message and create a dynamic reply. */
 	int     (*handler)(uint32_t *rx_payload, uint32_t *tx_payload,
@@ -68,7 +80,30 @@ scpi_cmd_get_scp_cap_handler(uint32_t *rx_payload UNUSED,
 	                BIT(SCPI_CMD_GET_SCP_CAP) |
 	                BIT(SCPI_CMD_SET_CSS_POWER) |
 	                BIT(SCPI_CMD_GET_CSS_POWER) |
-	                BIT(SCPI_CMD_SET_SYS_POWER);
+	                BIT(SCPI_CMD_SET_SYS_POWER) |
+	                BIT(SCPI_CMD_SET_CPU_TIMER) |
+	                BIT(SCPI_CMD_CANCEL_CPU_TIMER);
+	if (CONFIG(THS))
+		tx_payload[3] |= BIT(SCPI_CMD_GET_SENSOR_CAP) |
+		                 BIT(SCPI_CMD_GET_SENSOR_INFO) |
+		                 BIT(SCPI_CMD_GET_SENSOR) |
+		                 BIT(SCPI_CMD_CFG_SENSOR_PERIOD) |
+		                 BIT(SCPI_CMD_CFG_SENSOR_BOUNDS);
+	if (CONFIG(DVFS))
+		tx_payload[3] |= BIT(SCPI_CMD_GET_DVFS_CAP) |
+		                 BIT(SCPI_CMD_GET_DVFS_INFO) |
+		                 BIT(SCPI_CMD_SET_DVFS) |
+		                 BIT(SCPI_CMD_GET_DVFS);
+	if (CONFIG(CLOCK_SERVICE))
+		tx_payload[3] |= BIT(SCPI_CMD_GET_CLOCK_CAP) |
+		                 BIT(SCPI_CMD_GET_CLOCK_INFO) |
+		                 BIT(SCPI_CMD_SET_CLOCK) |
+		                 BIT(SCPI_CMD_GET_CLOCK);
+	if (CONFIG(PSU_SERVICE))
+		tx_payload[3] |= BIT(SCPI_CMD_GET_PSU_CAP) |
+		                 BIT(SCPI_CMD_GET_PSU_INFO) |
+		                 BIT(SCPI_CMD_SET_PSU) |
+		                 BIT(SCPI_CMD_GET_PSU);
 	/* Commands enabled 1. */
 	tx_payload[4] = 0;
 	/* Commands enabled 2. */
@@ -104,6 +139,10 @@ scpi_cmd_set_css_power_handler(uint32_t *rx_payload,
 	uint32_t css_state     = bitfield_get(descriptor, 0x10, 4);
 	int err;
 
+	/* Wait for the core to enter WFI without blocking other clients. */
+	if (core_state == SCPI_CSS_OFF && !css_core_in_wfi(cluster, core))
+		return SCPI_PENDING;
+
 	err = css_set_power_state(cluster, core, core_state,
 	                          cluster_state, css_state);
 	if (err)
@@ -173,6 +212,416 @@ scpi_cmd_set_sys_power_handler(uint32_t *rx_payload,
 	return SCPI_OK;
 }
 
+/*
+ * Handler for SCPI_CMD_SET_CPU_TIMER: Set CPU timer.
+ *
+ * The SCP does not share a time base with the CPUs, so the timestamp is
+ * interpreted as a delay in microseconds from when the command is received.
+ * Expiration wakes the system if it is suspended or off.
+ */
+static int
+scpi_cmd_set_cpu_timer_handler(uint32_t *rx_payload,
+                               uint32_t *tx_payload UNUSED,
+                               uint16_t *tx_size UNUSED)
+{
+	/* The timestamp is a 64-bit quantity. */
+	if (rx_payload[1])
+		return SCPI_E_RANGE;
+
+	if (system_set_wake_timer(rx_payload[0]))
+		return SCPI_E_DEVICE;
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_CANCEL_CPU_TIMER: Cancel CPU timer.
+ */
+static int
+scpi_cmd_cancel_cpu_timer_handler(uint32_t *rx_payload UNUSED,
+                                  uint32_t *tx_payload UNUSED,
+                                  uint16_t *tx_size UNUSED)
+{
+	system_cancel_wake_timer();
+
+	return SCPI_OK;
+}
+
+#if CONFIG(DVFS)
+/*
+ * Handler for SCPI_CMD_GET_DVFS_CAP: Get DVFS capability.
+ *
+ * Each cluster supporting DVFS is a separate DVFS domain.
+ */
+static int
+scpi_cmd_get_dvfs_cap_handler(uint32_t *rx_payload UNUSED,
+                              uint32_t *tx_payload, uint16_t *tx_size)
+{
+	tx_payload[0] = css_get_dvfs_count();
+	*tx_size      = sizeof(uint8_t);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_GET_DVFS_INFO: Get DVFS info.
+ */
+#define DVFS_INFO_HEADER(domain, count, latency) \
+	((domain) | (count) << 8 | (latency) << 16)
+static int
+scpi_cmd_get_dvfs_info_handler(uint32_t *rx_payload,
+                               uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t domain = bitfield_get(rx_payload[0], 0, 8);
+	const struct css_opp *opps;
+	uint32_t count, latency;
+	int err;
+
+	if ((err = css_get_opps(domain, &opps, &count, &latency)))
+		return err;
+
+	tx_payload[0] = DVFS_INFO_HEADER(domain, count, latency);
+	for (uint32_t i = 0; i < count; ++i) {
+		tx_payload[1 + 2 * i] = opps[i].rate;
+		tx_payload[2 + 2 * i] = opps[i].voltage;
+	}
+	*tx_size = (1 + 2 * count) * sizeof(*tx_payload);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_SET_DVFS: Set DVFS.
+ */
+static int
+scpi_cmd_set_dvfs_handler(uint32_t *rx_payload,
+                          uint32_t *tx_payload UNUSED,
+                          uint16_t *tx_size UNUSED)
+{
+	uint32_t domain = bitfield_get(rx_payload[0], 0, 8);
+	uint32_t opp    = bitfield_get(rx_payload[0], 8, 8);
+
+	return css_set_opp(domain, opp);
+}
+
+/*
+ * Handler for SCPI_CMD_GET_DVFS: Get DVFS.
+ */
+static int
+scpi_cmd_get_dvfs_handler(uint32_t *rx_payload,
+                          uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t domain = bitfield_get(rx_payload[0], 0, 8);
+	uint32_t opp;
+	int err;
+
+	if ((err = css_get_opp(domain, &opp)))
+		return err;
+
+	tx_payload[0] = opp;
+	*tx_size      = sizeof(uint8_t);
+
+	return SCPI_OK;
+}
+#endif
+
+#if CONFIG(CLOCK_SERVICE)
+/*
+ * Handler for SCPI_CMD_GET_CLOCK_CAP: Get clock capability.
+ */
+static int
+scpi_cmd_get_clock_cap_handler(uint32_t *rx_payload UNUSED,
+                               uint32_t *tx_payload, uint16_t *tx_size)
+{
+	tx_payload[0] = scpi_clock_count;
+	*tx_size      = sizeof(uint16_t);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_GET_CLOCK_INFO: Get clock info.
+ *
+ * Clocks that cannot be written only report their current rate.
+ */
+static int
+scpi_cmd_get_clock_info_handler(uint32_t *rx_payload,
+                                uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id = bitfield_get(rx_payload[0], 0, 16);
+	const struct clock_handle *clock;
+	uint32_t flags, min_rate, max_rate;
+
+	if (id >= scpi_clock_count)
+		return SCPI_E_PARAM;
+
+	clock = &scpi_clocks[id].clock;
+	flags = scpi_clocks[id].flags;
+	if (flags & SCPI_FLAG_WRITABLE) {
+		min_rate = clock_round_rate(clock, 0);
+		max_rate = clock_round_rate(clock, UINT32_MAX);
+	} else {
+		min_rate = max_rate = clock_get_rate(clock);
+	}
+
+	tx_payload[0] = id | flags << 16;
+	tx_payload[1] = min_rate;
+	tx_payload[2] = max_rate;
+	*tx_size      = 3 * sizeof(*tx_payload);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_SET_CLOCK: Set clock value.
+ */
+static int
+scpi_cmd_set_clock_handler(uint32_t *rx_payload,
+                           uint32_t *tx_payload UNUSED,
+                           uint16_t *tx_size UNUSED)
+{
+	uint32_t id   = bitfield_get(rx_payload[0], 0, 16);
+	uint32_t rate = rx_payload[1];
+	const struct clock_handle *clock;
+
+	if (id >= scpi_clock_count)
+		return SCPI_E_PARAM;
+	if (!(scpi_clocks[id].flags & SCPI_FLAG_WRITABLE))
+		return SCPI_E_ACCESS;
+
+	/* Do not change the rate underneath a firmware driver. */
+	clock = &scpi_clocks[id].clock;
+	if (clock_active(clock))
+		return SCPI_E_ACCESS;
+	if (clock_set_rate(clock, rate))
+		return SCPI_E_DEVICE;
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_GET_CLOCK: Get clock value.
+ */
+static int
+scpi_cmd_get_clock_handler(uint32_t *rx_payload,
+                           uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id = bitfield_get(rx_payload[0], 0, 16);
+
+	if (id >= scpi_clock_count)
+		return SCPI_E_PARAM;
+	if (!(scpi_clocks[id].flags & SCPI_FLAG_READABLE))
+		return SCPI_E_ACCESS;
+
+	tx_payload[0] = clock_get_rate(&scpi_clocks[id].clock);
+	*tx_size      = sizeof(uint32_t);
+
+	return SCPI_OK;
+}
+#endif
+
+#if CONFIG(PSU_SERVICE)
+/*
+ * Handler for SCPI_CMD_GET_PSU_CAP: Get power supply capability.
+ */
+static int
+scpi_cmd_get_psu_cap_handler(uint32_t *rx_payload UNUSED,
+                             uint32_t *tx_payload, uint16_t *tx_size)
+{
+	tx_payload[0] = scpi_psu_count;
+	*tx_size      = sizeof(uint16_t);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_GET_PSU_INFO: Get power supply info.
+ *
+ * No supply can be written, so each reports its voltage as both the minimum
+ * and the maximum.
+ */
+static int
+scpi_cmd_get_psu_info_handler(uint32_t *rx_payload,
+                              uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id = bitfield_get(rx_payload[0], 0, 16);
+	uint32_t voltage;
+
+	if (id >= scpi_psu_count)
+		return SCPI_E_PARAM;
+
+	if (regulator_list_get_voltage(id, &voltage))
+		return SCPI_E_DEVICE;
+
+	tx_payload[0] = id | scpi_psus[id].flags << 16;
+	tx_payload[1] = voltage;
+	tx_payload[2] = voltage;
+	*tx_size      = 3 * sizeof(*tx_payload);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_SET_PSU: Set power supply.
+ *
+ * The PMIC bus belongs to the rich OS while it is running, so the firmware
+ * cannot change any supply voltage, and every supply is read-only.
+ */
+static int
+scpi_cmd_set_psu_handler(uint32_t *rx_payload,
+                         uint32_t *tx_payload UNUSED,
+                         uint16_t *tx_size UNUSED)
+{
+	uint32_t id = bitfield_get(rx_payload[0], 0, 16);
+
+	if (id >= scpi_psu_count)
+		return SCPI_E_PARAM;
+
+	return SCPI_E_ACCESS;
+}
+
+/*
+ * Handler for SCPI_CMD_GET_PSU: Get power supply.
+ */
+static int
+scpi_cmd_get_psu_handler(uint32_t *rx_payload,
+                         uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id = bitfield_get(rx_payload[0], 0, 16);
+	uint32_t voltage;
+
+	if (id >= scpi_psu_count)
+		return SCPI_E_PARAM;
+	if (!(scpi_psus[id].flags & SCPI_FLAG_READABLE))
+		return SCPI_E_ACCESS;
+
+	if (regulator_list_get_voltage(id, &voltage))
+		return SCPI_E_DEVICE;
+
+	tx_payload[0] = voltage;
+	*tx_size      = sizeof(uint32_t);
+
+	return SCPI_OK;
+}
+#endif
+
+/*
+ * Handler for SCPI_CMD_GET_SENSOR_CAP: Get sensor capability.
+ */
+static int
+scpi_cmd_get_sensor_cap_handler(uint32_t *rx_payload UNUSED,
+                                uint32_t *tx_payload, uint16_t *tx_size)
+{
+	tx_payload[0] = scpi_sensor_count;
+	*tx_size      = sizeof(uint16_t);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_GET_SENSOR_INFO: Get sensor info.
+ *
+ * The reply contains the sensor ID, its class, the supported trigger types,
+ * and a NUL-padded 20-byte name.
+ */
+static int
+scpi_cmd_get_sensor_info_handler(uint32_t *rx_payload,
+                                 uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id = bitfield_get(rx_payload[0], 0, 16);
+	const struct scpi_sensor *sensor;
+	const char *name;
+
+	if (id >= scpi_sensor_count)
+		return SCPI_E_PARAM;
+
+	sensor = &scpi_sensors[id];
+	tx_payload[0] = id | sensor->class << 16 |
+	                (SCPI_TRIGGER_PERIODIC | SCPI_TRIGGER_BOUNDS) << 24;
+	for (uint8_t i = 1; i <= 5; ++i)
+		tx_payload[i] = 0;
+	/* Always leave room for the terminating NUL. */
+	name = sensor->name;
+	for (uint8_t i = 0; i < 19 && name[i]; ++i)
+		tx_payload[1 + i / 4] |= (uint32_t)name[i] << (8 * (i % 4));
+	*tx_size = 6 * sizeof(*tx_payload);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_GET_SENSOR: Get sensor value.
+ *
+ * Periodically sampled sensors report their last sampled value.
+ */
+static int
+scpi_cmd_get_sensor_handler(uint32_t *rx_payload,
+                            uint32_t *tx_payload, uint16_t *tx_size)
+{
+	uint32_t id = bitfield_get(rx_payload[0], 0, 16);
+	uint32_t value;
+	int err;
+
+	if (id >= scpi_sensor_count)
+		return SCPI_E_PARAM;
+
+	if ((err = sensor_list_get_value(id, &value)))
+		return err == EBUSY ? SCPI_E_BUSY : SCPI_E_DEVICE;
+
+	/* The value is a 64-bit quantity. */
+	tx_payload[0] = value;
+	tx_payload[1] = 0;
+	*tx_size      = 2 * sizeof(*tx_payload);
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_CFG_SENSOR_PERIOD: Configure sensor period.
+ *
+ * The period is given in milliseconds. Zero disables periodic sampling.
+ */
+static int
+scpi_cmd_cfg_sensor_period_handler(uint32_t *rx_payload,
+                                   uint32_t *tx_payload UNUSED,
+                                   uint16_t *tx_size UNUSED)
+{
+	uint32_t id = bitfield_get(rx_payload[0], 0, 16);
+
+	if (id >= scpi_sensor_count)
+		return SCPI_E_PARAM;
+
+	if (sensor_list_set_period(id, rx_payload[1]))
+		return SCPI_E_RANGE;
+
+	return SCPI_OK;
+}
+
+/*
+ * Handler for SCPI_CMD_CFG_SENSOR_BOUNDS: Configure sensor bounds.
+ *
+ * The bounds are 64-bit values. Bounds above the 32-bit range of the sensor
+ * value are saturated.
+ */
+static int
+scpi_cmd_cfg_sensor_bounds_handler(uint32_t *rx_payload,
+                                   uint32_t *tx_payload UNUSED,
+                                   uint16_t *tx_size UNUSED)
+{
+	uint32_t id    = bitfield_get(rx_payload[0], 0, 16);
+	uint32_t lower = rx_payload[2] ? UINT32_MAX : rx_payload[1];
+	uint32_t upper = rx_payload[4] ? UINT32_MAX : rx_payload[3];
+
+	if (id >= scpi_sensor_count)
+		return SCPI_E_PARAM;
+	if (lower > upper)
+		return SCPI_E_RANGE;
+
+	sensor_list_set_bounds(id, lower, upper);
+
+	return SCPI_OK;
+}
+
 /*
  * The list of supported SCPI commands.
  */
@@ -197,17 +646,95 @@ static const struct scpi_cmd scpi_cmds[] = {
 		.rx_size = sizeof(uint8_t),
 		.flags   = FLAG_SECURE_ONLY,
 	},
+	[SCPI_CMD_SET_CPU_TIMER] = {
+		.handler = scpi_cmd_set_cpu_timer_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+	[SCPI_CMD_CANCEL_CPU_TIMER] = {
+		.handler = scpi_cmd_cancel_cpu_timer_handler,
+	},
+#if CONFIG(DVFS)
+	[SCPI_CMD_GET_DVFS_CAP] = {
+		.handler = scpi_cmd_get_dvfs_cap_handler,
+	},
+	[SCPI_CMD_GET_DVFS_INFO] = {
+		.handler = scpi_cmd_get_dvfs_info_handler,
+		.rx_size = sizeof(uint8_t),
+	},
+	[SCPI_CMD_SET_DVFS] = {
+		.handler = scpi_cmd_set_dvfs_handler,
+		.rx_size = 2 * sizeof(uint8_t),
+	},
+	[SCPI_CMD_GET_DVFS] = {
+		.handler = scpi_cmd_get_dvfs_handler,
+		.rx_size = sizeof(uint8_t),
+	},
+#endif
+#if CONFIG(CLOCK_SERVICE)
+	[SCPI_CMD_GET_CLOCK_CAP] = {
+		.handler = scpi_cmd_get_clock_cap_handler,
+	},
+	[SCPI_CMD_GET_CLOCK_INFO] = {
+		.handler = scpi_cmd_get_clock_info_handler,
+		.rx_size = sizeof(uint16_t),
+	},
+	[SCPI_CMD_SET_CLOCK] = {
+		.handler = scpi_cmd_set_clock_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+	[SCPI_CMD_GET_CLOCK] = {
+		.handler = scpi_cmd_get_clock_handler,
+		.rx_size = sizeof(uint16_t),
+	},
+#endif
+#if CONFIG(PSU_SERVICE)
+	[SCPI_CMD_GET_PSU_CAP] = {
+		.handler = scpi_cmd_get_psu_cap_handler,
+	},
+	[SCPI_CMD_GET_PSU_INFO] = {
+		.handler = scpi_cmd_get_psu_info_handler,
+		.rx_size = sizeof(uint16_t),
+	},
+	[SCPI_CMD_SET_PSU] = {
+		.handler = scpi_cmd_set_psu_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+	[SCPI_CMD_GET_PSU] = {
+		.handler = scpi_cmd_get_psu_handler,
+		.rx_size = sizeof(uint16_t),
+	},
+#endif
+	[SCPI_CMD_GET_SENSOR_CAP] = {
+		.handler = scpi_cmd_get_sensor_cap_handler,
+	},
+	[SCPI_CMD_GET_SENSOR_INFO] = {
+		.handler = scpi_cmd_get_sensor_info_handler,
+		.rx_size = sizeof(uint16_t),
+	},
+	[SCPI_CMD_GET_SENSOR] = {
+		.handler = scpi_cmd_get_sensor_handler,
+		.rx_size = sizeof(uint16_t),
+	},
+	[SCPI_CMD_CFG_SENSOR_PERIOD] = {
+		.handler = scpi_cmd_cfg_sensor_period_handler,
+		.rx_size = 2 * sizeof(uint32_t),
+	},
+	[SCPI_CMD_CFG_SENSOR_BOUNDS] = {
+		.handler = scpi_cmd_cfg_sensor_bounds_handler,
+		.rx_size = 5 * sizeof(uint32_t),
+	},
 };
 
 /*
  * Generic SCPI command handling function.
  */
-bool
+uint8_t
 scpi_handle_cmd(uint8_t client, struct scpi_mem *mem)
 {
 	struct scpi_msg *rx_msg = &mem->rx_msg;
 	struct scpi_msg *tx_msg = &mem->tx_msg;
 	const struct scpi_cmd *cmd;
+	int status;
 
 	/* Initialize the response (defaults for unsupported commands). */
 	tx_msg->command = rx_msg->command;
@@ -217,7 +744,7 @@ scpi_handle_cmd(uint8_t client, struct scpi_mem *mem)
 
 	/* Avoid reading past the end of the array; reply with the error. */
 	if (rx_msg->command >= ARRAY_SIZE(scpi_cmds))
-		return true;
+		return SCPI_REPLY;
 	cmd = &scpi_cmds[rx_msg->command];
 
 	/* Update the command status and payload based on the message. */
@@ -229,12 +756,15 @@ scpi_handle_cmd(uint8_t client, struct scpi_mem *mem)
 		tx_msg->status = SCPI_E_SIZE;
 	} else if (cmd->handler) {
 		/* Run the handler for this command to make a response. */
-		tx_msg->status = cmd->handler(rx_msg->payload, tx_msg->payload,
-		                              &tx_msg->size);
+		status = cmd->handler(rx_msg->payload, tx_msg->payload,
+		                      &tx_msg->size);
+		if (status == SCPI_PENDING)
+			return SCPI_DEFERRED;
+		tx_msg->status = status;
 	} else {
 		debug("SCPI%u: Bad command: %u", client, rx_msg->command);
 	}
 
 	/* Report back if a reply should be sent. */
-	return !(cmd->flags & FLAG_NO_REPLY);
+	return cmd->flags & FLAG_NO_REPLY ? SCPI_HANDLED : SCPI_REPLY;
 }
@@ -0,0 +1,254 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <css.h>
+#include <debug.h>
+#include <device.h>
+#include <error.h>
+#include <intrusive.h>
+#include <scmi.h>
+#include <scpi.h>
+#include <scpi_protocol.h>
+#include <sensor.h>
+#include <sensor_list.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <timer.h>
+#include <util.h>
+#include <sensor/sunxi-ths.h>
+
+/* The default sampling period in milliseconds. */
+#define DEFAULT_PERIOD     1000
+
+/* Throttling is released once all sensors cool down by this much. */
+#define THROTTLE_HYSTERESIS 10000
+
+#if CONFIG(THS) && CONFIG(DVFS)
+#define THROTTLE_TEMP      (CONFIG_THS_THROTTLE_TEMP * 1000U)
+#else
+#define THROTTLE_TEMP      0
+#endif
+
+#define THS_SENSOR(id, name) \
+	{ { &ths.dev, (id) }, (name), SCPI_SENSOR_TEMPERATURE }
+
+struct sensor_state {
+	/** The timer used for periodic sampling. */
+	struct timer timer;
+	/** The sampling period in milliseconds, or zero if not sampling. */
+	uint32_t     period;
+	/** The most recently sampled value. */
+	uint32_t     value;
+	/** The lower bound for notifications, if bounded. */
+	uint32_t     lower;
+	/** The upper bound for notifications, if bounded. */
+	uint32_t     upper;
+	/** Whether the firmware holds a reference to the sensor provider. */
+	bool         active;
+	/** Whether the sampled value is valid. */
+	bool         valid;
+	/** Whether the client is notified of values outside the bounds. */
+	bool         bounded;
+	/** Whether the client is notified of every sampled value. */
+	bool         periodic;
+	/** Whether the last sampled value was outside the bounds. */
+	bool         outside;
+	/** Whether the sensor is above the throttling temperature. */
+	bool         hot;
+};
+
+#if CONFIG(THS)
+
+const struct scpi_sensor scpi_sensors[] = {
+#if CONFIG(PLATFORM_A64) && CONFIG(SOC_A64)
+	THS_SENSOR(0, "cpu_thermal"),
+	THS_SENSOR(1, "gpu0_thermal"),
+	THS_SENSOR(2, "gpu1_thermal"),
+#elif CONFIG(PLATFORM_A64) || CONFIG(PLATFORM_H6)
+	THS_SENSOR(0, "cpu_thermal"),
+	THS_SENSOR(1, "gpu_thermal"),
+#else
+	THS_SENSOR(0, "cpu_thermal"),
+#endif
+};
+
+const uint8_t scpi_sensor_count = ARRAY_SIZE(scpi_sensors);
+
+static struct sensor_state sensor_states[ARRAY_SIZE(scpi_sensors)];
+
+#else
+
+/* Keep a placeholder element, since empty arrays are not allowed. */
+const struct scpi_sensor scpi_sensors[1];
+const uint8_t scpi_sensor_count = 0;
+
+static struct sensor_state sensor_states[1];
+
+#endif
+
+#if THROTTLE_TEMP
+static void
+sensor_list_update_throttle(void)
+{
+	static bool throttled;
+	bool hot = false;
+
+	for (uint8_t id = 0; id < scpi_sensor_count; ++id)
+		hot |= sensor_states[id].hot;
+
+	/* Retry on each sample, in case DVFS was not in use before. */
+	hot = css_set_throttle(hot);
+	if (hot != throttled) {
+		warn("Thermal throttling %s", hot ? "on" : "off");
+		throttled = hot;
+	}
+}
+#endif
+
+/*
+ * Send the sampled value of a sensor to the rich OS. SCMI only reports
+ * crossings of its trip points, which are implemented with the bounds.
+ */
+static void
+sensor_list_notify(uint8_t id, uint32_t value, bool crossed)
+{
+	/* The value is a 64-bit quantity. */
+	uint32_t payload[] = { id, value, 0 };
+
+	if (CONFIG(SCMI)) {
+		if (crossed)
+			scmi_sensor_event(id, value);
+		return;
+	}
+
+	scpi_create_message(SCPI_CLIENT_EL2, SCPI_CMD_ASYNC_SENSOR,
+	                    payload, sizeof(payload));
+}
+
+static void
+sensor_list_sample(struct timer *timer)
+{
+	struct sensor_state *state =
+		container_of(timer, struct sensor_state, timer);
+	uint8_t id = state - sensor_states;
+	bool crossed, outside;
+
+	/* On failure, keep reporting the last good value. */
+	if (sensor_read(&scpi_sensors[id].sensor, &state->value))
+		return;
+	state->valid = true;
+
+	/* Notify the client only when the value first leaves the bounds. */
+	outside = state->bounded && (state->value < state->lower ||
+	                             state->value > state->upper);
+	crossed = outside && !state->outside;
+	if (state->periodic || crossed)
+		sensor_list_notify(id, state->value, crossed);
+	state->outside = outside;
+
+#if THROTTLE_TEMP
+	/* Only act on temperatures known to be accurate. */
+	if (scpi_sensors[id].class == SCPI_SENSOR_TEMPERATURE &&
+	    sensor_calibrated(&scpi_sensors[id].sensor)) {
+		if (state->value >= THROTTLE_TEMP)
+			state->hot = true;
+		else if (state->value + THROTTLE_HYSTERESIS < THROTTLE_TEMP)
+			state->hot = false;
+		sensor_list_update_throttle();
+	}
+#endif
+}
+
+static void
+sensor_list_start(uint8_t id)
+{
+	struct sensor_state *state = &sensor_states[id];
+	uint32_t period = state->period;
+
+	/* Keep sampling for throttling, even without a client period. */
+	if (!period && THROTTLE_TEMP)
+		period = DEFAULT_PERIOD;
+
+	if (state->active && period)
+		timer_start(&state->timer, sensor_list_sample,
+		            period * 1000, true);
+}
+
+int
+sensor_list_get_value(uint8_t id, uint32_t *value)
+{
+	struct sensor_state *state = &sensor_states[id];
+
+	if (!state->active)
+		return ENODEV;
+
+	/* Without periodic sampling, there is no cached value. */
+	if (!state->period || !state->valid)
+		return sensor_read(&scpi_sensors[id].sensor, value);
+
+	*value = state->value;
+
+	return SUCCESS;
+}
+
+int
+sensor_list_set_period(uint8_t id, uint32_t period)
+{
+	struct sensor_state *state = &sensor_states[id];
+
+	if (period > UINT32_MAX / 1000)
+		return ERANGE;
+
+	timer_stop(&state->timer);
+	state->period   = period;
+	state->periodic = period > 0;
+	state->valid    = false;
+	sensor_list_start(id);
+
+	return SUCCESS;
+}
+
+void
+sensor_list_set_bounds(uint8_t id, uint32_t lower, uint32_t upper)
+{
+	struct sensor_state *state = &sensor_states[id];
+
+	state->lower   = lower;
+	state->upper   = upper;
+	state->bounded = true;
+	state->outside = false;
+}
+
+void
+sensor_list_init(void)
+{
+	for (uint8_t id = 0; id < scpi_sensor_count; ++id)
+		sensor_states[id].period = DEFAULT_PERIOD;
+}
+
+void
+sensor_list_resume(void)
+{
+	for (uint8_t id = 0; id < scpi_sensor_count; ++id) {
+		struct sensor_state *state = &sensor_states[id];
+
+		state->active = !device_get(scpi_sensors[id].sensor.dev);
+		state->valid  = false;
+		sensor_list_start(id);
+	}
+}
+
+void
+sensor_list_suspend(void)
+{
+	for (uint8_t id = 0; id < scpi_sensor_count; ++id) {
+		struct sensor_state *state = &sensor_states[id];
+
+		timer_stop(&state->timer);
+		if (state->active)
+			device_put(scpi_sensors[id].sensor.dev);
+		state->active = false;
+	}
+}
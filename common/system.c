@@ -5,27 +5,38 @@
 
 #include <cir.h>
 #include <counter.h>
+#include <cpu.h>
 #include <css.h>
 #include <debug.h>
 #include <delay.h>
 #include <device.h>
 #include <dram.h>
+#include <error.h>
 #include <exception.h>
 #include <irq.h>
 #include <pmic.h>
+#include <regmap.h>
 #include <regulator.h>
 #include <regulator_list.h>
+#include <scmi.h>
 #include <scpi.h>
+#include <sensor_list.h>
 #include <serial.h>
 #include <simple_device.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <system.h>
+#include <timeout.h>
+#include <timer.h>
+#include <util.h>
 #include <version.h>
 #include <watchdog.h>
 #include <clock/ccu.h>
 #include <gpio/sunxi-gpio.h>
 #include <msgbox/sunxi-msgbox.h>
+#include <timer/sunxi-timer.h>
 #include <watchdog/sunxi-twd.h>
+#include <platform/irq.h>
 
 #define NEXT_STATE (system_state + 2)
 
@@ -65,6 +76,32 @@ enum {
 /* This variable is persisted across exception restarts. */
 static uint8_t system_state = SS_BOOT;
 
+#define WAKE_LEAD_INITIAL (50 * USEC_PER_MSEC) /* 50ms */
+#define WAKE_LEAD_MARGIN  (1 * USEC_PER_MSEC)  /* 1ms */
+#define WAKE_LEAD_MAX     (1 * USEC_PER_SEC)   /* 1s */
+
+/*
+ * The PMIC restores its outputs in a sequence, with delays between the steps
+ * that it does not report. Wait at least this long after pmic_resume().
+ */
+#define PMIC_RESUME_TIME  (10 * USEC_PER_MSEC) /* 10ms */
+
+/* How long to keep the CPU clock fast after the last runtime request. */
+#define BUSY_HOLD_TIME    (10 * USEC_PER_MSEC) /* 10ms */
+
+/* A reference to the wakeup timer, held while the timer is armed. */
+static const struct device *wake_timer;
+
+/* The measured time needed to resume, used to start resuming early. */
+static uint32_t wake_lead;
+/* How early the wakeup timer will fire, or zero if it is not early. */
+static uint32_t wake_early;
+/* Whether the system is resuming because the wakeup timer fired. */
+static bool     wake_fired;
+
+/* Running while the CPU clock is held fast for a burst of requests. */
+static struct timer busy_timer;
+
 static uint8_t
 select_suspend_depth(uint8_t current_state)
 {
@@ -80,12 +117,126 @@ select_suspend_depth(uint8_t current_state)
 	return SD_VDD_SYS;
 }
 
+/*
+ * Get the time needed for every supply that may have been turned off during
+ * suspend to rise back into regulation, but no less than the given minimum.
+ */
+static uint32_t
+select_ramp_time(uint32_t min)
+{
+	const struct regulator_handle *const supplies[] = {
+		&cpu_supply,
+		&dram_supply,
+		&vcc_pll_supply,
+		&vdd_sys_supply,
+	};
+	uint32_t max = min;
+
+	for (uint8_t i = 0; i < ARRAY_SIZE(supplies); ++i) {
+		uint32_t time = regulator_get_ramp_time(supplies[i]);
+
+		if (time > max)
+			max = time;
+	}
+
+	return max;
+}
+
+/*
+ * Move the wakeup timer deadline earlier by the expected resume latency, so
+ * the CPUs can be turned on at the requested time.
+ */
+static void
+wake_timer_suspend(void)
+{
+	uint32_t remaining;
+
+	/* A timer that expired while the system was awake already fired. */
+	if (sunxi_timer_poll(wake_timer)) {
+		system_cancel_wake_timer();
+		return;
+	}
+
+	if (!wake_lead)
+		wake_lead = WAKE_LEAD_INITIAL;
+
+	remaining = sunxi_timer_remaining(wake_timer);
+	if (remaining > wake_lead) {
+		wake_early = wake_lead;
+		sunxi_timer_start(wake_timer, remaining - wake_early);
+	}
+}
+
+static bool
+wake_timer_poll(void)
+{
+	if (!sunxi_timer_poll(wake_timer))
+		return false;
+
+	/* Count down the rest of the delay while resuming. */
+	if (wake_early) {
+		sunxi_timer_start(wake_timer, wake_early);
+		wake_fired = true;
+	}
+
+	return true;
+}
+
+/*
+ * Wait for the original wakeup timer deadline, if resuming started early, and
+ * update the resume latency estimate. If something else woke the system,
+ * restore the original deadline instead, or release the timer if it expired.
+ */
+static void
+wake_timer_resume(void)
+{
+	uint32_t remaining = sunxi_timer_remaining(wake_timer);
+	uint64_t deadline, timeout;
+
+	/* Release a timer that fired at its original deadline. */
+	if (!wake_early) {
+		if (sunxi_timer_poll(wake_timer))
+			system_cancel_wake_timer();
+		return;
+	}
+
+	if (!wake_fired) {
+		sunxi_timer_start(wake_timer, remaining + wake_early);
+		wake_early = 0;
+		return;
+	}
+
+	/* If the deadline was missed, the latency is unknown, so back off. */
+	if (remaining)
+		wake_lead = wake_early - remaining + WAKE_LEAD_MARGIN;
+	else if (wake_lead < WAKE_LEAD_MAX / 2)
+		wake_lead *= 2;
+
+	/*
+	 * The remaining time is bounded by the lead, but it can still be long
+	 * enough to need the watchdog restarted, so keep running the software
+	 * timers and doze between them.
+	 */
+	timeout = timeout_set(remaining);
+	while (!sunxi_timer_poll(wake_timer)) {
+		timer_poll();
+		deadline = timer_next_deadline();
+		if (deadline > timeout)
+			deadline = timeout;
+		cpu_doze(deadline);
+	}
+	system_cancel_wake_timer();
+}
+
 noreturn void
 system_state_machine(uint32_t exception)
 {
+	const struct regulator_handle *supplies[REGULATOR_LIST_MAX];
 	const struct device *cir, *mailbox, *pmic, *watchdog;
 	uint8_t initial_state = system_state;
 	uint8_t suspend_depth;
+	uint32_t ramp_time;
+	uint8_t count;
 
 	if (initial_state > SS_BOOT) {
 		/*
@@ -113,9 +264,24 @@ system_state_machine(uint32_t exception)
 		ccu_init();
 		css_init();
 		dram_init();
+		sensor_list_init();
 
 		/* Acquire runtime-only devices. */
 		mailbox = device_get_or_null(&msgbox.dev);
+		sensor_list_resume();
+
+		/*
+		 * The secure monitor waits for SCP_READY before it starts
+		 * the rich OS, so nothing else is using the PMIC yet. After
+		 * a restart while awake, the rich OS owns the PMIC bus.
+		 */
+		if (initial_state == SS_BOOT) {
+			css_update_opp_limits();
+			regulator_list_update();
+			device_release_idle();
+		} else {
+			css_restore_opp_limits();
+		}
 	}
 
 	/*
@@ -144,28 +310,64 @@ system_state_machine(uint32_t exception)
 	if (mailbox && initial_state == SS_BOOT) {
 		info("Crust " VERSION_STRING);
 
-		scpi_create_message(mailbox, SCPI_CLIENT_EL3,
-		                    SCPI_CMD_SCP_READY);
+		scpi_create_message(SCPI_CLIENT_EL3, SCPI_CMD_SCP_READY,
+		                    NULL, 0);
 	}
 
 	for (;;) {
+		/* Run any expired timers, including the watchdog restart. */
+		timer_poll();
+
 		switch (system_state) {
 		case SS_AWAKE:
-			/* Poll runtime devices. */
-			if (watchdog)
-				watchdog_restart(watchdog);
+			/* Poll runtime services. Skip dozing while busy. */
+			if (mailbox) {
+				bool busy = scpi_poll(mailbox);
+
+				busy |= scmi_poll(mailbox);
+				if (busy) {
+					/* Handle the rest at full speed. */
+					r_ccu_set_busy(true);
+					timer_start(&busy_timer, NULL,
+					            BUSY_HOLD_TIME, false);
+					break;
+				}
+			}
 
-			/* Poll runtime services. */
+			/*
+			 * Idle at the lowest-power CPU clock rate, but only
+			 * once requests stop arriving, so a burst of requests
+			 * does not switch the clock back and forth.
+			 */
+			if (!timer_running(&busy_timer))
+				r_ccu_set_busy(false);
+
+			/*
+			 * Doze until an IRQ arrives or the next timer expires.
+			 * Keep interrupts disabled while arming the IRQ, so it
+			 * is not masked before dozing.
+			 */
+			cpu_disable_irqs();
 			if (mailbox)
-				scpi_poll(mailbox);
+				irq_enable(IRQ_MSGBOX);
+			cpu_doze(timer_next_deadline());
+			cpu_enable_irqs();
 
 			break;
 		case SS_SHUTDOWN:
 		case SS_SUSPEND:
 			info("Suspending...");
 
+			/* Only wakeup IRQs are polled while off/asleep. */
+			cpu_disable_irqs();
+			irq_disable(IRQ_MSGBOX);
+
 			/* Release runtime-only devices. */
 			device_put(mailbox), mailbox = NULL;
+			sensor_list_suspend();
+
+			/* Linux cannot access the PMIC until resume. */
+			regmap_cache_set_enabled(true);
 
 			/* Synchronize device state with Linux. */
 			simple_device_sync(&pio);
@@ -173,14 +375,23 @@ system_state_machine(uint32_t exception)
 
 			/* Acquire wakeup sources. */
 			cir = cir_get();
+			if (wake_timer && system_state == SS_SUSPEND)
+				wake_timer_suspend();
+			else if (wake_timer && sunxi_timer_poll(wake_timer))
+				system_cancel_wake_timer();
 
 			/* Configure the SoC for minimal power consumption. */
 			dram_suspend();
 			device_put(&uart.dev);
+			/* PLLs may be disabled after this point. */
+			r_ccu_set_busy(false);
 			ccu_suspend();
 			baud = 300;
 			device_get(&uart.dev);
 
+			/* Gate peripheral clocks that Linux left running. */
+			ccu_suspend_unused(&ccu);
+
 			/*
 			 * Disable watchdog protection. Once devices outside
 			 * the SoC (oscillators and regulators) are disabled,
@@ -201,18 +412,24 @@ system_state_machine(uint32_t exception)
 					pmic_suspend(pmic);
 			}
 
-			/* Turn off all unnecessary power domains. */
-			regulator_disable(&cpu_supply);
+			/*
+			 * Turn off all unnecessary power domains. Supplies
+			 * from the same regulator device are turned off
+			 * together, so they share register writes.
+			 */
+			supplies[0] = &cpu_supply;
+			count       = 1;
 			if (system_state == SS_SHUTDOWN)
-				regulator_disable(&dram_supply);
+				supplies[count++] = &dram_supply;
 			if (suspend_depth >= SD_OSC24M &&
 			    (!CONFIG(VCC_PLL_POWERS_AVCC) ||
 			     suspend_depth >= SD_AVCC) &&
 			    (!CONFIG(VCC_PLL_POWERS_DRAM) ||
 			     system_state == SS_SHUTDOWN))
-				regulator_disable(&vcc_pll_supply);
+				supplies[count++] = &vcc_pll_supply;
 			if (suspend_depth >= SD_VDD_SYS)
-				regulator_disable(&vdd_sys_supply);
+				supplies[count++] = &vdd_sys_supply;
+			regulator_disable_list(supplies, count);
 
 			/*
 			 * The regulator provider is often part of the same
@@ -221,6 +438,10 @@ system_state_machine(uint32_t exception)
 			 */
 			device_put(pmic);
 
+			/* Gate bus controllers kept alive for autosuspend. */
+			device_release_idle();
+			ccu_suspend_unused(&r_ccu);
+
 			info("Suspend to %d complete!", suspend_depth);
 
 			/* The system is now off or asleep. */
@@ -232,7 +453,8 @@ system_state_machine(uint32_t exception)
 			debug_print_battery();
 
 			/* Poll wakeup sources. Reset or resume on wakeup. */
-			if ((cir && cir_poll(cir)) || irq_poll())
+			if ((cir && cir_poll(cir)) || irq_poll() ||
+			    (wake_timer && wake_timer_poll()))
 				system_state = NEXT_STATE;
 
 			/* This must run last so the state change is seen. */
@@ -245,16 +467,18 @@ system_state_machine(uint32_t exception)
 			 * The PMIC is expected to restore regulator state.
 			 * If it fails, manually turn the regulators back on.
 			 */
+			ramp_time = PMIC_RESUME_TIME;
 			if (!(pmic = pmic_get()) || pmic_resume(pmic)) {
 				regulator_enable(&vdd_sys_supply);
 				regulator_enable(&vcc_pll_supply);
 				regulator_enable(&dram_supply);
 				regulator_enable(&cpu_supply);
+				ramp_time = 0;
 			}
 			device_put(pmic);
 
 			/* Give regulator outputs time to rise. */
-			udelay(25000);
+			udelay(select_ramp_time(ramp_time));
 
 			/* Restore SoC-internal power domains. */
 			r_ccu_resume();
@@ -266,10 +490,15 @@ system_state_machine(uint32_t exception)
 			system_state = NEXT_STATE;
 			break;
 		case SS_RESUME:
+			/* PLLs are running again, so speed up the resume. */
+			r_ccu_set_busy(true);
+
 			info("Resuming...");
 
 			/* Configure the SoC for full functionality. */
 			ccu_resume();
+			ccu_resume_unused(&ccu);
+			ccu_resume_unused(&r_ccu);
 			dram_resume();
 
 			/* Release wakeup sources. */
@@ -277,6 +506,17 @@ system_state_machine(uint32_t exception)
 
 			/* Acquire runtime-only devices. */
 			mailbox = device_get_or_null(&msgbox.dev);
+			sensor_list_resume();
+
+			/* Hold off until the time requested by the timer. */
+			if (wake_timer)
+				wake_timer_resume();
+
+			/* Linux may use the PMIC after this point. */
+			css_update_opp_limits();
+			regulator_list_update();
+			regmap_cache_set_enabled(false);
+			device_release_idle();
 
 			/* Resume execution on the first CPU in the CSS. */
 			css_set_power_state(0, 0, SCPI_CSS_ON,
@@ -309,6 +549,14 @@ system_state_machine(uint32_t exception)
 	}
 }
 
+void
+system_cancel_wake_timer(void)
+{
+	device_put(wake_timer), wake_timer = NULL;
+	wake_early = 0;
+	wake_fired = false;
+}
+
 void
 system_reboot(void)
 {
@@ -327,6 +575,17 @@ system_reset(void)
 	system_state = SS_RESET;
 }
 
+int
+system_set_wake_timer(uint32_t useconds)
+{
+	if (!wake_timer && !(wake_timer = device_get_or_null(&r_timer.dev)))
+		return EIO;
+
+	sunxi_timer_start(wake_timer, useconds);
+
+	return SUCCESS;
+}
+
 void
 system_shutdown(void)
 {
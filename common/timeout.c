@@ -3,28 +3,93 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <clock.h>
 #include <counter.h>
-#include <debug.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <timeout.h>
-#include <platform/time.h>
+#include <clock/ccu.h>
+
+/** CPU clock (and system counter) cycles per microsecond, in Q16.16. */
+static uint32_t cycles_per_usec;
+/** The conversion factor before the last CPU clock rate change. */
+static uint32_t old_cycles_per_usec;
+
+/**
+ * Compute (a * b) >> 16 without a 64-bit multiplication, which would need a
+ * libgcc helper.
+ */
+static uint64_t
+mul_shr16(uint32_t a, uint32_t b)
+{
+	uint32_t ah = a >> 16, al = a & 0xffff;
+	uint32_t bh = b >> 16, bl = b & 0xffff;
+
+	return ((uint64_t)(ah * bh) << 16) + ah * bl + al * bh +
+	       ((al * bl) >> 16);
+}
+
+uint64_t
+timeout_cycles(uint32_t useconds)
+{
+	/* The factor is lost when .bss is cleared by an exception restart. */
+	if (unlikely(!cycles_per_usec))
+		timeout_update_rate();
+
+	return mul_shr16(useconds, cycles_per_usec);
+}
 
 bool
-timeout_expired(uint32_t timeout)
+timeout_expired(uint64_t timeout)
 {
-	uint32_t now = counter_read();
+	return counter_read_64() >= timeout;
+}
+
+uint64_t
+timeout_rescale(uint64_t timeout)
+{
+	uint64_t now = counter_read_64();
+	uint32_t cycles, div, quot, usecs;
+
+	if (!old_cycles_per_usec || timeout <= now)
+		return timeout;
+
+	cycles = timeout - now > UINT32_MAX ? UINT32_MAX : timeout - now;
 
-	/* If the timeout wrapped, wait until the counter also wraps. */
-	return (now ^ timeout) >> 31 == 0 && now >= timeout;
+	/*
+	 * Divide by the old factor in Q8.8 so each 32-bit step stays in
+	 * range. The remainder keeps the result exact to a microsecond. Below
+	 * one cycle per microsecond (such as from a 32 kHz clock), the result
+	 * may not fit in 32 bits, so saturate it.
+	 */
+	div  = old_cycles_per_usec >> 8;
+	quot = cycles / div;
+	if (quot > UINT32_MAX >> 8)
+		usecs = UINT32_MAX;
+	else
+		usecs = (quot << 8) + ((cycles % div) << 8) / div;
+
+	return now + timeout_cycles(usecs);
 }
 
-uint32_t
+uint64_t
 timeout_set(uint32_t useconds)
 {
-	uint32_t cycles = CPUCLK_MHz * useconds;
-	uint32_t now    = counter_read();
+	return counter_read_64() + timeout_cycles(useconds);
+}
+
+void
+timeout_update_rate(void)
+{
+	static const struct clock_handle cpu = { &r_ccu.dev, CLK_AR100 };
+	uint32_t rate = clock_get_rate(&cpu);
 
-	/* Ensure the MSB is zero for the wraparound check above. */
-	assert(cycles >> 31 == 0);
+	old_cycles_per_usec = cycles_per_usec;
 
-	return now + cycles;
+	/*
+	 * rate * 2^16 / 10^6 == rate * 2^10 / 15625. Split the division to
+	 * avoid overflow, and round up so delays are never too short.
+	 */
+	cycles_per_usec = (rate / 15625 << 10) +
+	                  ((rate % 15625 << 10) + 15624) / 15625;
 }
@@ -0,0 +1,114 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <counter.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <timeout.h>
+#include <timer.h>
+
+/** The list of running timers, sorted by deadline. */
+static struct timer *timers;
+
+static void
+timer_insert(struct timer *timer)
+{
+	struct timer **link = &timers;
+
+	/* Timers with the same deadline expire in the order they started. */
+	while (*link && (*link)->deadline <= timer->deadline)
+		link = &(*link)->next;
+
+	timer->next    = *link;
+	timer->running = true;
+	*link          = timer;
+}
+
+static void
+timer_remove(struct timer *timer)
+{
+	struct timer **link = &timers;
+
+	while (*link && *link != timer)
+		link = &(*link)->next;
+
+	if (*link)
+		*link = timer->next;
+	timer->running = false;
+}
+
+uint64_t
+timer_next_deadline(void)
+{
+	if (!timers)
+		return UINT64_MAX;
+
+	return timers->deadline;
+}
+
+void
+timer_poll(void)
+{
+	uint64_t now = counter_read_64();
+	struct timer *timer;
+
+	while ((timer = timers) && timer->deadline <= now) {
+		timers = timer->next;
+
+		if (timer->period) {
+			/* Convert every period in case the CPU clock changed. */
+			uint64_t cycles = timeout_cycles(timer->period);
+
+			timer->deadline += cycles;
+			/* Skip any periods that were missed entirely. */
+			if (timer->deadline <= now)
+				timer->deadline = now + cycles;
+			timer_insert(timer);
+		} else {
+			timer->running = false;
+		}
+
+		/* The function may restart or stop this or any other timer. */
+		if (timer->fn)
+			timer->fn(timer);
+	}
+}
+
+bool
+timer_running(const struct timer *timer)
+{
+	return timer->running;
+}
+
+void
+timer_start(struct timer *timer, timer_fn *fn, uint32_t useconds,
+            bool periodic)
+{
+	if (timer->running)
+		timer_remove(timer);
+
+	timer->fn       = fn;
+	timer->deadline = timeout_set(useconds);
+	timer->period   = periodic ? useconds : 0;
+	timer_insert(timer);
+}
+
+void
+timer_update_rate(void)
+{
+	timeout_update_rate();
+
+	/* The conversion is monotonic, so the list stays sorted. */
+	for (struct timer *timer = timers; timer; timer = timer->next)
+		timer->deadline = timeout_rescale(timer->deadline);
+}
+
+void
+timer_stop(struct timer *timer)
+{
+	if (timer->running)
+		timer_remove(timer);
+}
@@ -5,10 +5,13 @@
 
 #include <bitmap.h>
 #include <clock.h>
+#include <debug.h>
 #include <device.h>
 #include <error.h>
 #include <intrusive.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <util.h>
 #include <clock/ccu.h>
 
 #include "ccu.h"
@@ -19,6 +22,23 @@ to_ccu(const struct device *dev)
 	return container_of(dev, const struct ccu, dev);
 }
 
+/**
+ * Apply changes to a clock's configuration register by setting the update
+ * bit, and if requested, wait for the lock bit to be set.
+ */
+static void
+ccu_commit(const struct ccu *self, const struct ccu_clock *clk, bool wait)
+{
+	uintptr_t regs = self->regs;
+
+	/* Apply the changes by setting the update bit, if applicable. */
+	if (clk->update)
+		mmio_set_32(regs + clk->reg, BIT(clk->update));
+	/* Wait for the lock bit to be set, if applicable. */
+	if (clk->lock && wait)
+		mmio_poll_32(regs + clk->reg, BIT(clk->lock));
+}
+
 const struct clock_handle *
 ccu_get_null_parent(const struct ccu *self UNUSED,
                     const struct ccu_clock *clk UNUSED)
@@ -70,6 +90,57 @@ ccu_get_state(const struct clock_handle *clock)
 	return CLOCK_STATE_ENABLED;
 }
 
+static uint32_t
+ccu_round_rate(const struct clock_handle *clock, uint32_t parent_rate,
+               uint32_t rate)
+{
+	const struct ccu *self      = to_ccu(clock->dev);
+	const struct ccu_clock *clk = &self->clocks[clock->id];
+
+	/* A clock without a round_rate hook can only run at its rate. */
+	if (!clk->round_rate)
+		return clk->get_rate(self, clk, parent_rate);
+
+	return clk->round_rate(self, clk, parent_rate, rate);
+}
+
+static int
+ccu_set_parent(const struct clock_handle *clock,
+               const struct clock_handle *parent)
+{
+	const struct ccu *self      = to_ccu(clock->dev);
+	const struct ccu_clock *clk = &self->clocks[clock->id];
+	int err;
+
+	if (!clk->set_parent)
+		return ENOTSUP;
+	if ((err = clk->set_parent(self, clk, parent)))
+		return err;
+
+	ccu_commit(self, clk, false);
+
+	return SUCCESS;
+}
+
+static int
+ccu_set_rate(const struct clock_handle *clock, uint32_t parent_rate,
+             uint32_t rate)
+{
+	const struct ccu *self      = to_ccu(clock->dev);
+	const struct ccu_clock *clk = &self->clocks[clock->id];
+	int err;
+
+	if (!clk->set_rate)
+		return ENOTSUP;
+	if ((err = clk->set_rate(self, clk, parent_rate, rate)))
+		return err;
+
+	/* A gated PLL will not lock until it is enabled. */
+	ccu_commit(self, clk, ccu_get_state(clock) == CLOCK_STATE_ENABLED);
+
+	return SUCCESS;
+}
+
 static void
 ccu_set_state(const struct clock_handle *clock, uint32_t state)
 {
@@ -89,12 +160,59 @@ ccu_set_state(const struct clock_handle *clock, uint32_t state)
 	/* Once the device is in/out of reset, (un)gate the clock. */
 	if (clk->gate)
 		(ungate ? bitmap_set : bitmap_clear)(regs, clk->gate);
-	/* Apply the changes by setting the update bit, if applicable. */
-	if (clk->update)
-		mmio_set_32(regs + clk->reg, BIT(clk->update));
-	/* Wait for the lock bit to be set, if applicable. */
-	if (clk->lock && ungate)
-		mmio_poll_32(regs + clk->reg, BIT(clk->lock));
+	/* Apply the changes and wait for the clock to become stable. */
+	ccu_commit(self, clk, ungate);
+}
+
+void
+ccu_suspend_unused(const struct ccu *self)
+{
+	struct clock_device_state *state =
+		container_of(self->dev.state, struct clock_device_state, ds);
+
+	for (uint8_t id = 0; id < self->num_clocks; ++id) {
+		const struct clock_handle clock = {
+			.dev = &self->dev,
+			.id  = id,
+		};
+
+		/*
+		 * Only clocks in this table are audited. Skip clocks without
+		 * a gate, and clocks the firmware uses.
+		 */
+		if (!self->clocks[id].gate || state->cs[id].refcount)
+			continue;
+		if (ccu_get_state(&clock) != CLOCK_STATE_ENABLED)
+			continue;
+
+		/* Gate, but do not reset, to preserve the device's state. */
+		ccu_set_state(&clock, CLOCK_STATE_GATED);
+		state->unused |= BIT(id);
+
+		debug("%s: Gated unused clock %u", self->dev.name, id);
+	}
+}
+
+void
+ccu_resume_unused(const struct ccu *self)
+{
+	struct clock_device_state *state =
+		container_of(self->dev.state, struct clock_device_state, ds);
+
+	for (uint8_t id = 0; id < self->num_clocks; ++id) {
+		const struct clock_handle clock = {
+			.dev = &self->dev,
+			.id  = id,
+		};
+
+		/* Leave alone any clock the firmware has since acquired. */
+		if (!(state->unused & BIT(id)) || state->cs[id].refcount)
+			continue;
+
+		ccu_set_state(&clock, CLOCK_STATE_ENABLED);
+	}
+
+	state->unused = 0;
 }
 
 const struct clock_driver ccu_driver = {
@@ -106,6 +224,9 @@ const struct clock_driver ccu_driver = {
 		.get_parent = ccu_get_parent,
 		.get_rate   = ccu_get_rate,
 		.get_state  = ccu_get_state,
+		.round_rate = ccu_round_rate,
+		.set_parent = ccu_set_parent,
+		.set_rate   = ccu_set_rate,
 		.set_state  = ccu_set_state,
 	},
 };
@@ -7,11 +7,16 @@
 #define CCU_PRIVATE_H
 
 #include <clock.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <clock/ccu.h>
 
 #include "clock.h"
 
+/** The number of clocks that fit in the unused clock bitmap. */
+#define CCU_MAX_CLOCKS 32
+
 #define DEFINE_FIXED_PARENT(_name, _dev, _id) \
 	UNUSED const struct clock_handle * \
 	_name(const struct ccu *self UNUSED, \
@@ -39,6 +44,19 @@ struct ccu_clock {
 	uint32_t                   (*get_rate)(const struct ccu *self,
 	                                       const struct ccu_clock *clk,
 	                                       uint32_t rate);
+	/** Hook for finding the closest supported rate (optional). */
+	uint32_t                   (*round_rate)(const struct ccu *self,
+	                                         const struct ccu_clock *clk,
+	                                         uint32_t parent_rate,
+	                                         uint32_t rate);
+	/** Hook for selecting a new parent clock (optional). */
+	int (*set_parent)(const struct ccu *self, const struct ccu_clock *clk,
+	                  const struct clock_handle *parent);
+	/** Hook for programming a new rate (optional). */
+	int                        (*set_rate)(const struct ccu *self,
+	                                       const struct ccu_clock *clk,
+	                                       uint32_t parent_rate,
+	                                       uint32_t rate);
 	/** Byte offset of the clock configuration register. */
 	uint16_t reg;
 	/** Offset of the lock bit inside the register (valid if nonzero). */
@@ -82,10 +100,66 @@ uint32_t ccu_helper_get_rate_mp(const struct ccu *self,
                                 const struct ccu_clock *clk, uint32_t rate,
                                 uint32_t m_shift, uint32_t m_width,
                                 uint32_t p_shift, uint32_t p_width);
+uint32_t ccu_helper_get_rate_nmp(const struct ccu *self,
+                                 const struct ccu_clock *clk, uint32_t rate,
+                                 uint32_t n_shift, uint32_t n_width,
+                                 uint32_t m_shift, uint32_t m_width,
+                                 uint32_t p_shift, uint32_t p_width);
 uint32_t ccu_helper_get_rate_p(const struct ccu *self,
                                const struct ccu_clock *clk, uint32_t rate,
                                uint32_t p_shift, uint32_t p_width);
 
+/*
+ * The round_rate and set_rate helpers choose the fastest rate that does not
+ * exceed the requested rate. If every possible rate is too fast, they choose
+ * the slowest possible rate. N and M fields hold the factor minus one, and P
+ * fields hold a power-of-two exponent.
+ */
+uint32_t ccu_helper_round_rate_m(const struct ccu *self,
+                                 const struct ccu_clock *clk,
+                                 uint32_t parent_rate, uint32_t rate,
+                                 uint32_t m_width);
+uint32_t ccu_helper_round_rate_mp(const struct ccu *self,
+                                  const struct ccu_clock *clk,
+                                  uint32_t parent_rate, uint32_t rate,
+                                  uint32_t m_width, uint32_t p_width);
+uint32_t ccu_helper_round_rate_nmp(const struct ccu *self,
+                                   const struct ccu_clock *clk,
+                                   uint32_t parent_rate, uint32_t rate,
+                                   uint32_t n_width, uint32_t m_width,
+                                   uint32_t p_width);
+uint32_t ccu_helper_round_rate_p(const struct ccu *self,
+                                 const struct ccu_clock *clk,
+                                 uint32_t parent_rate, uint32_t rate,
+                                 uint32_t p_width);
+
+int ccu_helper_set_parent_mux(const struct ccu *self,
+                              const struct ccu_clock *clk,
+                              const struct clock_handle *parent,
+                              const struct clock_handle *parents,
+                              size_t count,
+                              uint32_t mux_shift, uint32_t mux_width);
+
+int ccu_helper_set_rate_m(const struct ccu *self,
+                          const struct ccu_clock *clk,
+                          uint32_t parent_rate, uint32_t rate,
+                          uint32_t m_shift, uint32_t m_width);
+int ccu_helper_set_rate_mp(const struct ccu *self,
+                           const struct ccu_clock *clk,
+                           uint32_t parent_rate, uint32_t rate,
+                           uint32_t m_shift, uint32_t m_width,
+                           uint32_t p_shift, uint32_t p_width);
+int ccu_helper_set_rate_nmp(const struct ccu *self,
+                            const struct ccu_clock *clk,
+                            uint32_t parent_rate, uint32_t rate,
+                            uint32_t n_shift, uint32_t n_width,
+                            uint32_t m_shift, uint32_t m_width,
+                            uint32_t p_shift, uint32_t p_width);
+int ccu_helper_set_rate_p(const struct ccu *self,
+                          const struct ccu_clock *clk,
+                          uint32_t parent_rate, uint32_t rate,
+                          uint32_t p_shift, uint32_t p_width);
+
 /*
  * r_ccu_common.c
  * ==============
@@ -96,6 +170,7 @@ uint32_t r_ccu_common_get_osc16m_rate(const struct ccu *self,
                                       uint32_t rate);
 void r_ccu_common_suspend(uint8_t depth);
 void r_ccu_common_resume(void);
+void r_ccu_common_set_busy(bool busy);
 void r_ccu_common_init(void);
 
 #endif /* CCU_PRIVATE_H */
@@ -4,11 +4,68 @@
  */
 
 #include <bitfield.h>
+#include <clock.h>
+#include <error.h>
 #include <mmio.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <util.h>
 
 #include "ccu.h"
 
+struct ccu_factors {
+	uint32_t n; /**< Multiplier, with the register field holding n - 1. */
+	uint32_t m; /**< Divider, with the register field holding m - 1. */
+	uint32_t p; /**< Power-of-two divider, stored as the exponent. */
+};
+
+/**
+ * Find the factors producing the fastest rate not above the target rate, or
+ * if no such factors exist, the slowest possible rate. A field with zero
+ * width is not present in the hardware, so its factor is fixed at one.
+ */
+static uint32_t
+ccu_helper_find_factors(uint32_t parent_rate, uint32_t rate,
+                        uint32_t n_width, uint32_t m_width, uint32_t p_width,
+                        struct ccu_factors *best)
+{
+	uint32_t best_rate = 0;
+	bool found = false;
+
+	for (uint32_t p = 0; p < BIT(p_width); ++p) {
+		for (uint32_t m = 1; m <= BIT(m_width); ++m) {
+			uint32_t step = (parent_rate / m) >> p;
+			uint32_t n, new_rate;
+
+			if (!step)
+				continue;
+
+			/* The multiplier is chosen directly, not searched. */
+			n = rate / step;
+			if (n > BIT(n_width))
+				n = BIT(n_width);
+			if (n < 1)
+				n = 1;
+			new_rate = step * n;
+
+			/* Prefer smaller dividers when the rates are equal. */
+			if (found && (new_rate > rate ?
+			              best_rate <= rate ||
+			              new_rate >= best_rate :
+			              best_rate <= rate &&
+			              new_rate <= best_rate))
+				continue;
+
+			*best     = (struct ccu_factors) { n, m, p };
+			best_rate = new_rate;
+			found     = true;
+		}
+	}
+
+	return best_rate;
+}
+
 uint32_t
 ccu_helper_get_rate_m(const struct ccu *self,
                       const struct ccu_clock *clk, uint32_t rate,
@@ -35,6 +92,22 @@ ccu_helper_get_rate_mp(const struct ccu *self,
 	return rate;
 }
 
+uint32_t
+ccu_helper_get_rate_nmp(const struct ccu *self,
+                        const struct ccu_clock *clk, uint32_t rate,
+                        uint32_t n_shift, uint32_t n_width,
+                        uint32_t m_shift, uint32_t m_width,
+                        uint32_t p_shift, uint32_t p_width)
+{
+	uint32_t val = mmio_read_32(self->regs + clk->reg);
+
+	rate  /= bitfield_get(val, m_shift, m_width) + 1;
+	rate >>= bitfield_get(val, p_shift, p_width);
+	rate  *= bitfield_get(val, n_shift, n_width) + 1;
+
+	return rate;
+}
+
 uint32_t
 ccu_helper_get_rate_p(const struct ccu *self,
                       const struct ccu_clock *clk, uint32_t rate,
@@ -46,3 +119,128 @@ ccu_helper_get_rate_p(const struct ccu *self,
 
 	return rate;
 }
+
+uint32_t
+ccu_helper_round_rate_m(const struct ccu *self UNUSED,
+                        const struct ccu_clock *clk UNUSED,
+                        uint32_t parent_rate, uint32_t rate,
+                        uint32_t m_width)
+{
+	struct ccu_factors f;
+
+	return ccu_helper_find_factors(parent_rate, rate, 0, m_width, 0, &f);
+}
+
+uint32_t
+ccu_helper_round_rate_mp(const struct ccu *self UNUSED,
+                         const struct ccu_clock *clk UNUSED,
+                         uint32_t parent_rate, uint32_t rate,
+                         uint32_t m_width, uint32_t p_width)
+{
+	struct ccu_factors f;
+
+	return ccu_helper_find_factors(parent_rate, rate,
+	                               0, m_width, p_width, &f);
+}
+
+uint32_t
+ccu_helper_round_rate_nmp(const struct ccu *self UNUSED,
+                          const struct ccu_clock *clk UNUSED,
+                          uint32_t parent_rate, uint32_t rate,
+                          uint32_t n_width, uint32_t m_width,
+                          uint32_t p_width)
+{
+	struct ccu_factors f;
+
+	return ccu_helper_find_factors(parent_rate, rate,
+	                               n_width, m_width, p_width, &f);
+}
+
+uint32_t
+ccu_helper_round_rate_p(const struct ccu *self UNUSED,
+                        const struct ccu_clock *clk UNUSED,
+                        uint32_t parent_rate, uint32_t rate,
+                        uint32_t p_width)
+{
+	struct ccu_factors f;
+
+	return ccu_helper_find_factors(parent_rate, rate, 0, 0, p_width, &f);
+}
+
+int
+ccu_helper_set_parent_mux(const struct ccu *self,
+                          const struct ccu_clock *clk,
+                          const struct clock_handle *parent,
+                          const struct clock_handle *parents, size_t count,
+                          uint32_t mux_shift, uint32_t mux_width)
+{
+	for (size_t i = 0; i < count; ++i) {
+		if (parents[i].dev != parent->dev ||
+		    parents[i].id != parent->id)
+			continue;
+
+		mmio_set_bitfield_32(self->regs + clk->reg,
+		                     mux_shift, mux_width, i);
+
+		return SUCCESS;
+	}
+
+	return EINVAL;
+}
+
+int
+ccu_helper_set_rate_m(const struct ccu *self,
+                      const struct ccu_clock *clk,
+                      uint32_t parent_rate, uint32_t rate,
+                      uint32_t m_shift, uint32_t m_width)
+{
+	return ccu_helper_set_rate_nmp(self, clk, parent_rate, rate,
+	                               0, 0, m_shift, m_width, 0, 0);
+}
+
+int
+ccu_helper_set_rate_mp(const struct ccu *self,
+                       const struct ccu_clock *clk,
+                       uint32_t parent_rate, uint32_t rate,
+                       uint32_t m_shift, uint32_t m_width,
+                       uint32_t p_shift, uint32_t p_width)
+{
+	return ccu_helper_set_rate_nmp(self, clk, parent_rate, rate,
+	                               0, 0, m_shift, m_width,
+	                               p_shift, p_width);
+}
+
+int
+ccu_helper_set_rate_nmp(const struct ccu *self,
+                        const struct ccu_clock *clk,
+                        uint32_t parent_rate, uint32_t rate,
+                        uint32_t n_shift, uint32_t n_width,
+                        uint32_t m_shift, uint32_t m_width,
+                        uint32_t p_shift, uint32_t p_width)
+{
+	uintptr_t reg = self->regs + clk->reg;
+	struct ccu_factors f;
+	uint32_t val;
+
+	if (!ccu_helper_find_factors(parent_rate, rate,
+	                             n_width, m_width, p_width, &f))
+		return EINVAL;
+
+	val = mmio_read_32(reg);
+	val = bitfield_set(val, n_shift, n_width, f.n - 1);
+	val = bitfield_set(val, m_shift, m_width, f.m - 1);
+	val = bitfield_set(val, p_shift, p_width, f.p);
+	mmio_write_32(reg, val);
+
+	return SUCCESS;
+}
+
+int
+ccu_helper_set_rate_p(const struct ccu *self,
+                      const struct ccu_clock *clk,
+                      uint32_t parent_rate, uint32_t rate,
+                      uint32_t p_shift, uint32_t p_width)
+{
+	return ccu_helper_set_rate_nmp(self, clk, parent_rate, rate,
+	                               0, 0, 0, 0, p_shift, p_width);
+}
@@ -8,10 +8,14 @@
 #include <device.h>
 #include <error.h>
 #include <intrusive.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "clock.h"
 
+/** Incremented whenever any cached clock rate may have become stale. */
+static uint32_t clock_generation;
+
 /**
  * Get the ops for the controller device providing this clock.
  */
@@ -36,6 +40,20 @@ clock_state_for(const struct clock_handle *clock)
 	return &state->cs[clock->id];
 }
 
+/**
+ * Get the rate of a clock's parent, or zero if the clock has no parent.
+ */
+static uint32_t
+clock_get_parent_rate(const struct clock_handle *clock)
+{
+	const struct clock_handle *parent;
+
+	if ((parent = clock_ops_for(clock)->get_parent(clock)))
+		return clock_get_rate(parent);
+
+	return 0;
+}
+
 bool
 clock_active(const struct clock_handle *clock)
 {
@@ -105,15 +123,20 @@ uint32_t
 clock_get_rate(const struct clock_handle *clock)
 {
 	const struct clock_driver_ops *ops = clock_ops_for(clock);
-	const struct clock_handle *parent;
-	uint32_t rate = 0;
+	struct clock_state *state = clock_state_for(clock);
+	uint32_t rate;
 
-	/* Initialize the rate with the parent's rate or a known safe value. */
-	if ((parent = ops->get_parent(clock)))
-		rate = clock_get_rate(parent);
+	/* Use the cached rate if no clock has changed since it was saved. */
+	if (state->rate && state->generation == clock_generation)
+		return state->rate;
 
 	/* Call the driver function to calculate this clock's rate. */
-	return ops->get_rate(clock, rate);
+	rate = ops->get_rate(clock, clock_get_parent_rate(clock));
+
+	state->rate       = rate;
+	state->generation = clock_generation;
+
+	return rate;
 }
 
 uint32_t
@@ -136,6 +159,12 @@ clock_get_state(const struct clock_handle *clock)
 	return ops->get_state(clock);
 }
 
+void
+clock_invalidate_rates(void)
+{
+	++clock_generation;
+}
+
 void
 clock_put(const struct clock_handle *clock)
 {
@@ -162,3 +191,57 @@ clock_put(const struct clock_handle *clock)
 	/* Drop the reference to the controller device. */
 	device_put(clock->dev);
 }
+
+uint32_t
+clock_round_rate(const struct clock_handle *clock, uint32_t rate)
+{
+	const struct clock_driver_ops *ops = clock_ops_for(clock);
+
+	return ops->round_rate(clock, clock_get_parent_rate(clock), rate);
+}
+
+int
+clock_set_parent(const struct clock_handle *clock,
+                 const struct clock_handle *parent)
+{
+	const struct clock_driver_ops *ops = clock_ops_for(clock);
+	const struct clock_handle *old_parent = ops->get_parent(clock);
+	bool active = clock_active(clock);
+	int err;
+
+	/* An active clock must keep a reference to its (new) parent. */
+	if (active && (err = clock_get(parent)))
+		return err;
+
+	if ((err = ops->set_parent(clock, parent))) {
+		if (active)
+			clock_put(parent);
+		return err;
+	}
+	clock_invalidate_rates();
+
+	debug("%s: Clock %u reparented to %s clock %u", clock->dev->name,
+	      clock->id, parent->dev->name, parent->id);
+
+	/* Drop the reference to the old parent clock. */
+	if (active && old_parent)
+		clock_put(old_parent);
+
+	return SUCCESS;
+}
+
+int
+clock_set_rate(const struct clock_handle *clock, uint32_t rate)
+{
+	const struct clock_driver_ops *ops = clock_ops_for(clock);
+	int err;
+
+	if ((err = ops->set_rate(clock, clock_get_parent_rate(clock), rate)))
+		return err;
+	clock_invalidate_rates();
+
+	debug("%s: Clock %u set to %u Hz", clock->dev->name,
+	      clock->id, clock_get_rate(clock));
+
+	return SUCCESS;
+}
@@ -15,11 +15,14 @@
 	&(char[sizeof_struct(struct clock_device_state, cs, n)]) { 0 }
 
 struct clock_state {
-	uint8_t refcount;
+	uint32_t rate;       /**< Cached rate, valid if nonzero. */
+	uint32_t generation; /**< Generation of the cached rate. */
+	uint8_t  refcount;
 };
 
 struct clock_device_state {
 	struct device_state ds;
+	uint32_t            unused; /**< Clocks gated while unused (CCU). */
 	struct clock_state  cs[];
 };
 
@@ -28,6 +31,12 @@ struct clock_driver_ops {
 	         (*get_parent)(const struct clock_handle *clock);
 	uint32_t (*get_rate)(const struct clock_handle *clock, uint32_t rate);
 	uint32_t (*get_state)(const struct clock_handle *clock);
+	uint32_t (*round_rate)(const struct clock_handle *clock,
+	                       uint32_t parent_rate, uint32_t rate);
+	int      (*set_parent)(const struct clock_handle *clock,
+	                       const struct clock_handle *parent);
+	int      (*set_rate)(const struct clock_handle *clock,
+	                     uint32_t parent_rate, uint32_t rate);
 	void     (*set_state)(const struct clock_handle *clock,
 	                      uint32_t state);
 };
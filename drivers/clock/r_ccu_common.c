@@ -3,11 +3,14 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <clock.h>
 #include <counter.h>
 #include <delay.h>
 #include <mmio.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <system.h>
+#include <timer.h>
 #include <watchdog/sunxi-twd.h>
 #include <platform/devices.h>
 #include <platform/prcm.h>
@@ -86,6 +89,14 @@ r_ccu_common_resume(void)
 void WEAK ATTRIBUTE(alias("r_ccu_common_resume"))
 r_ccu_resume(void);
 
+void
+r_ccu_common_set_busy(bool busy UNUSED)
+{
+}
+
+void WEAK ATTRIBUTE(alias("r_ccu_common_set_busy"))
+r_ccu_set_busy(bool busy);
+
 void
 r_ccu_common_init(void)
 {
@@ -113,4 +124,8 @@ r_ccu_common_init(void)
 	 * reference clock frequency.
 	 */
 	osc16m_rate = (after - before) << 9;
+	clock_invalidate_rates();
+
+	/* Delays and timers depend on the CPU clock rate. */
+	timer_update_rate();
 }
@@ -34,8 +34,92 @@
 
 #define AHB2_CLK_SRC(n)   ((n) << 0)
 
+#define CPUX_CLK_SRC_OSC24M   1
+#define CPUX_CLK_SRC_PLL_CPUX 2
+
+static DEFINE_FIXED_PARENT(ccu_get_osc24m, r_ccu, CLK_OSC24M)
+
 static DEFINE_FIXED_RATE(ccu_get_pll_periph0_rate, 600000000U)
 
+/*
+ * PLL_CPUX runs at OSC24M * N * K / (M * P). The M and P dividers are only
+ * meant for rates below 288MHz, so new rates are produced using N and K.
+ * The rate is only changed for DVFS.
+ */
+static uint32_t
+ccu_get_pll_cpux_k(const struct ccu *self, const struct ccu_clock *clk,
+                   uint32_t parent_rate, uint32_t rate)
+{
+	uint32_t best_k = 1, best_rate = 0;
+
+	for (uint32_t k = 1; k <= 4; ++k) {
+		uint32_t new_rate = ccu_helper_round_rate_nmp(self, clk,
+		                                              parent_rate * k,
+		                                              rate, 5, 0, 0);
+		if (new_rate <= rate && new_rate > best_rate) {
+			best_k    = k;
+			best_rate = new_rate;
+		}
+	}
+
+	return best_k;
+}
+
+static uint32_t
+ccu_get_pll_cpux_rate(const struct ccu *self, const struct ccu_clock *clk,
+                      uint32_t rate)
+{
+	uint32_t val = mmio_read_32(self->regs + clk->reg);
+
+	rate *= bitfield_get(val, 4, 2) + 1;
+
+	return ccu_helper_get_rate_nmp(self, clk, rate, 8, 5, 0, 2, 16, 2);
+}
+
+static uint32_t
+ccu_round_pll_cpux_rate(const struct ccu *self, const struct ccu_clock *clk,
+                        uint32_t parent_rate, uint32_t rate)
+{
+	uint32_t k = ccu_get_pll_cpux_k(self, clk, parent_rate, rate);
+
+	return ccu_helper_round_rate_nmp(self, clk, parent_rate * k,
+	                                 rate, 5, 0, 0);
+}
+
+static int
+ccu_set_pll_cpux_rate(const struct ccu *self, const struct ccu_clock *clk,
+                      uint32_t parent_rate, uint32_t rate)
+{
+	uintptr_t cpux_reg = self->regs + CPUX_AXI_CFG_REG;
+	uintptr_t reg      = self->regs + clk->reg;
+	uint32_t cpux_val  = mmio_read_32(cpux_reg);
+	uint32_t k = ccu_get_pll_cpux_k(self, clk, parent_rate, rate);
+	bool switch_parent;
+	uint32_t val;
+	int err;
+
+	/* Run the CPUs from OSC24M while the PLL relocks. */
+	switch_parent = bitfield_get(cpux_val, 16, 2) == CPUX_CLK_SRC_PLL_CPUX;
+	if (switch_parent)
+		mmio_write_32(cpux_reg, bitfield_set(cpux_val, 16, 2,
+		                                     CPUX_CLK_SRC_OSC24M));
+
+	val = mmio_read_32(reg);
+	val = bitfield_set(val, 0, 2, 0);
+	val = bitfield_set(val, 4, 2, k - 1);
+	val = bitfield_set(val, 16, 2, 0);
+	mmio_write_32(reg, val);
+	err = ccu_helper_set_rate_nmp(self, clk, parent_rate * k, rate,
+	                              8, 5, 0, 0, 0, 0);
+	if (bitmap_get(self->regs, clk->gate))
+		mmio_poll_32(reg, BIT(clk->lock));
+
+	if (switch_parent)
+		mmio_write_32(cpux_reg, cpux_val);
+
+	return err;
+}
+
 static DEFINE_FIXED_PARENT(ccu_get_apb2, ccu, CLK_APB2)
 
 static const struct clock_handle ccu_apb2_parents[] = {
@@ -93,8 +177,10 @@ ccu_get_dram_parent(const struct ccu *self, const struct ccu_clock *clk)
 
 static const struct ccu_clock ccu_clocks[SUN50I_A64_CCU_CLOCKS] = {
 	[CLK_PLL_CPUX] = {
-		.get_parent = ccu_get_null_parent,
-		.get_rate   = ccu_get_parent_rate,
+		.get_parent = ccu_get_osc24m,
+		.get_rate   = ccu_get_pll_cpux_rate,
+		.round_rate = CONFIG(DVFS) ? ccu_round_pll_cpux_rate : NULL,
+		.set_rate   = CONFIG(DVFS) ? ccu_set_pll_cpux_rate : NULL,
 		.reg        = 0x0000,
 		.lock       = 28,
 		.gate       = BITMAP_INDEX(0x0000, 31),
@@ -142,6 +228,12 @@ static const struct ccu_clock ccu_clocks[SUN50I_A64_CCU_CLOCKS] = {
 		.get_rate   = ccu_get_parent_rate,
 		.gate       = BITMAP_INDEX(0x0068, 5),
 	},
+	[CLK_BUS_THS] = {
+		.get_parent = ccu_get_null_parent,
+		.get_rate   = ccu_get_parent_rate,
+		.gate       = BITMAP_INDEX(0x0068, 8),
+		.reset      = BITMAP_INDEX(0x02d0, 8),
+	},
 #if CONFIG(SERIAL_DEV_UART0)
 	[CLK_BUS_UART0] = {
 		.get_parent = ccu_get_apb2,
@@ -191,6 +283,12 @@ static const struct ccu_clock ccu_clocks[SUN50I_A64_CCU_CLOCKS] = {
 		.gate       = BITMAP_INDEX(0x015c, 31),
 		.reset      = BITMAP_INDEX(0x00fc, 31),
 	},
+	/* The divider is left at its reset value of 1. */
+	[CLK_THS] = {
+		.get_parent = ccu_get_osc24m,
+		.get_rate   = ccu_get_parent_rate,
+		.gate       = BITMAP_INDEX(0x0074, 31),
+	},
 };
 
 const struct ccu ccu = {
@@ -199,10 +297,14 @@ const struct ccu ccu = {
 		.drv   = &ccu_driver.drv,
 		.state = CLOCK_DEVICE_STATE_INIT(SUN50I_A64_CCU_CLOCKS),
 	},
-	.clocks = ccu_clocks,
-	.regs   = DEV_CCU,
+	.clocks     = ccu_clocks,
+	.regs       = DEV_CCU,
+	.num_clocks = SUN50I_A64_CCU_CLOCKS,
 };
 
+static_assert(SUN50I_A64_CCU_CLOCKS <= CCU_MAX_CLOCKS,
+              "Too many clocks for the unused clock bitmap");
+
 static const struct clock_handle pll_cpux = {
 	.dev = &ccu.dev,
 	.id  = CLK_PLL_CPUX,
@@ -235,6 +337,8 @@ ccu_suspend(void)
 	              APB2_CLK_SRC(0) |
 	              APB2_CLK_P(0) |
 	              APB2_CLK_M(0));
+
+	clock_invalidate_rates();
 }
 
 void
@@ -264,6 +368,8 @@ ccu_resume(void)
 	              APB2_CLK_SRC(1) |
 	              APB2_CLK_P(0) |
 	              APB2_CLK_M(0));
+
+	clock_invalidate_rates();
 }
 
 void
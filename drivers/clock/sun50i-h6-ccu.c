@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <bitfield.h>
 #include <bitmap.h>
 #include <clock.h>
 #include <device.h>
@@ -38,10 +39,75 @@
 #define APB2_CLK_P(x)     ((x) << 8)
 #define APB2_CLK_M(x)     ((x) << 0)
 
+#define CPUX_CLK_SRC_OSC24M   0
+#define CPUX_CLK_SRC_PLL_CPUX 3
+
+/* The PLL is not stable with smaller multipliers. */
+#define PLL_CPUX_MIN_N        12
+
 static DEFINE_FIXED_RATE(ccu_get_pll_periph0_rate, 600000000U)
 
+static DEFINE_FIXED_PARENT(ccu_get_osc24m, r_ccu, CLK_OSC24M)
 static DEFINE_FIXED_PARENT(ccu_get_pll_ddr0, ccu, CLK_PLL_DDR0)
 
+/*
+ * PLL_CPUX runs at OSC24M * N / (M * P). The M and P dividers are only
+ * meant for rates below 288MHz, so new rates are produced using N alone.
+ * The rate is only changed for DVFS.
+ */
+static uint32_t
+ccu_get_pll_cpux_rate(const struct ccu *self, const struct ccu_clock *clk,
+                      uint32_t rate)
+{
+	return ccu_helper_get_rate_nmp(self, clk, rate, 8, 8, 0, 1, 16, 2);
+}
+
+static uint32_t
+ccu_round_pll_cpux_rate(const struct ccu *self, const struct ccu_clock *clk,
+                        uint32_t parent_rate, uint32_t rate)
+{
+	if (rate < parent_rate * PLL_CPUX_MIN_N)
+		rate = parent_rate * PLL_CPUX_MIN_N;
+
+	return ccu_helper_round_rate_nmp(self, clk, parent_rate, rate,
+	                                 8, 0, 0);
+}
+
+static int
+ccu_set_pll_cpux_rate(const struct ccu *self, const struct ccu_clock *clk,
+                      uint32_t parent_rate, uint32_t rate)
+{
+	uintptr_t cpux_reg = self->regs + CPUX_AXI_CFG_REG;
+	uintptr_t reg      = self->regs + clk->reg;
+	uint32_t cpux_val  = mmio_read_32(cpux_reg);
+	bool switch_parent;
+	uint32_t val;
+	int err;
+
+	if (rate < parent_rate * PLL_CPUX_MIN_N)
+		rate = parent_rate * PLL_CPUX_MIN_N;
+
+	/* Run the CPUs from OSC24M while the PLL relocks. */
+	switch_parent = bitfield_get(cpux_val, 24, 3) == CPUX_CLK_SRC_PLL_CPUX;
+	if (switch_parent)
+		mmio_write_32(cpux_reg, bitfield_set(cpux_val, 24, 3,
+		                                     CPUX_CLK_SRC_OSC24M));
+
+	val = mmio_read_32(reg);
+	val = bitfield_set(val, 0, 1, 0);
+	val = bitfield_set(val, 16, 2, 0);
+	mmio_write_32(reg, val);
+	err = ccu_helper_set_rate_nmp(self, clk, parent_rate, rate,
+	                              8, 8, 0, 0, 0, 0);
+	if (bitmap_get(self->regs, clk->gate))
+		mmio_poll_32(reg, BIT(clk->lock));
+
+	if (switch_parent)
+		mmio_write_32(cpux_reg, cpux_val);
+
+	return err;
+}
+
 /*
  * While APB2 has a mux, assume its parent is OSC24M. Reparenting APB2
  * to PLL_PERIPH0 in Linux for faster UART clocks is unsupported.
@@ -50,6 +116,15 @@ static DEFINE_FIXED_PARENT(ccu_get_apb2_parent, r_ccu, CLK_OSC24M)
 static DEFINE_FIXED_PARENT(ccu_get_apb2, ccu, CLK_APB2)
 
 static const struct ccu_clock ccu_clocks[SUN50I_H6_CCU_CLOCKS] = {
+	[CLK_PLL_CPUX] = {
+		.get_parent = ccu_get_osc24m,
+		.get_rate   = ccu_get_pll_cpux_rate,
+		.round_rate = CONFIG(DVFS) ? ccu_round_pll_cpux_rate : NULL,
+		.set_rate   = CONFIG(DVFS) ? ccu_set_pll_cpux_rate : NULL,
+		.reg        = 0x0000,
+		.lock       = 28,
+		.gate       = BITMAP_INDEX(0x0000, 31),
+	},
 	[CLK_PLL_DDR0] = {
 		.get_parent = ccu_get_null_parent,
 		.get_rate   = ccu_get_parent_rate,
@@ -94,6 +169,12 @@ static const struct ccu_clock ccu_clocks[SUN50I_H6_CCU_CLOCKS] = {
 		.get_parent = ccu_get_null_parent,
 		.get_rate   = ccu_get_parent_rate,
 	},
+	[CLK_BUS_THS] = {
+		.get_parent = ccu_get_null_parent,
+		.get_rate   = ccu_get_parent_rate,
+		.gate       = BITMAP_INDEX(0x09fc, 0),
+		.reset      = BITMAP_INDEX(0x09fc, 16),
+	},
 #if CONFIG(SERIAL_DEV_UART0)
 	[CLK_BUS_UART0] = {
 		.get_parent = ccu_get_apb2,
@@ -131,10 +212,14 @@ const struct ccu ccu = {
 		.drv   = &ccu_driver.drv,
 		.state = CLOCK_DEVICE_STATE_INIT(SUN50I_H6_CCU_CLOCKS),
 	},
-	.clocks = ccu_clocks,
-	.regs   = DEV_CCU,
+	.clocks     = ccu_clocks,
+	.regs       = DEV_CCU,
+	.num_clocks = SUN50I_H6_CCU_CLOCKS,
 };
 
+static_assert(SUN50I_H6_CCU_CLOCKS <= CCU_MAX_CLOCKS,
+              "Too many clocks for the unused clock bitmap");
+
 void
 ccu_suspend(void)
 {
@@ -161,6 +246,8 @@ ccu_suspend(void)
 	              APB1_CLK_SRC(1) |
 	              APB1_CLK_P(1) |
 	              APB1_CLK_M(0));
+
+	clock_invalidate_rates();
 }
 
 void
@@ -189,6 +276,8 @@ ccu_resume(void)
 	              APB1_CLK_SRC(3) |
 	              APB1_CLK_P(1) |
 	              APB1_CLK_M(2));
+
+	clock_invalidate_rates();
 }
 
 void
@@ -8,15 +8,29 @@
 #include <clock.h>
 #include <debug.h>
 #include <device.h>
+#include <error.h>
 #include <mmio.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <timer.h>
+#include <util.h>
 #include <clock/ccu.h>
 #include <platform/devices.h>
 #include <platform/prcm.h>
 
 #include "ccu.h"
 
+#define PLL_PERIPH0_CTRL_REG    (DEV_CCU + 0x0020)
+#define PLL_PERIPH0_CTRL_LOCKED (BIT(31) | BIT(28))
+
+#define CPUS_CLK_REG_FAST       (CPUS_CLK_REG_CLK_SRC(3) | \
+                                 CPUS_CLK_REG_PRE_DIV(2) | \
+                                 CPUS_CLK_REG_DIV_P(0))
+#define CPUS_CLK_REG_SLOW       (CPUS_CLK_REG_CLK_SRC(2) | \
+                                 CPUS_CLK_REG_PRE_DIV(0) | \
+                                 CPUS_CLK_REG_DIV_P(0))
+
 static DEFINE_FIXED_RATE(r_ccu_get_osc24m_rate, 24000000U)
 static DEFINE_FIXED_RATE(r_ccu_get_osc32k_rate, 32768U)
 
@@ -57,6 +71,65 @@ r_ccu_get_mp_rate(const struct ccu *self,
 	return ccu_helper_get_rate_mp(self, clk, rate, 0, 5, 8, 2);
 }
 
+static uint32_t
+r_ccu_round_bus_rate(const struct ccu *self,
+                     const struct ccu_clock *clk,
+                     uint32_t parent_rate, uint32_t rate)
+{
+	if (r_ccu_get_bus_parent(self, clk) == &r_ccu_bus_parents[3])
+		return ccu_helper_round_rate_mp(self, clk, parent_rate, rate,
+		                                5, 2);
+
+	return ccu_helper_round_rate_p(self, clk, parent_rate, rate, 2);
+}
+
+static int
+r_ccu_set_bus_parent(const struct ccu *self,
+                     const struct ccu_clock *clk,
+                     const struct clock_handle *parent)
+{
+	int err;
+
+	err = ccu_helper_set_parent_mux(self, clk, parent, r_ccu_bus_parents,
+	                                ARRAY_SIZE(r_ccu_bus_parents),
+	                                24, 2);
+
+	/* Maintain the assumption made by r_ccu_get_mp_rate(). */
+	if (!err && parent != &r_ccu_bus_parents[3])
+		mmio_set_bitfield_32(self->regs + clk->reg, 0, 5, 0);
+
+	return err;
+}
+
+static int
+r_ccu_set_bus_rate(const struct ccu *self,
+                   const struct ccu_clock *clk,
+                   uint32_t parent_rate, uint32_t rate)
+{
+	if (r_ccu_get_bus_parent(self, clk) == &r_ccu_bus_parents[3])
+		return ccu_helper_set_rate_mp(self, clk, parent_rate, rate,
+		                              0, 5, 8, 2);
+
+	return ccu_helper_set_rate_p(self, clk, parent_rate, rate, 8, 2);
+}
+
+static uint32_t
+r_ccu_round_mp_rate(const struct ccu *self,
+                    const struct ccu_clock *clk,
+                    uint32_t parent_rate, uint32_t rate)
+{
+	return ccu_helper_round_rate_mp(self, clk, parent_rate, rate, 5, 2);
+}
+
+static int
+r_ccu_set_mp_rate(const struct ccu *self,
+                  const struct ccu_clock *clk,
+                  uint32_t parent_rate, uint32_t rate)
+{
+	return ccu_helper_set_rate_mp(self, clk, parent_rate, rate,
+	                              0, 5, 8, 2);
+}
+
 static DEFINE_FIXED_PARENT(r_ccu_get_ar100, r_ccu, CLK_AR100)
 static DEFINE_FIXED_PARENT(r_ccu_get_r_ahb, r_ccu, CLK_R_AHB)
 
@@ -67,6 +140,22 @@ r_ccu_get_r_apb1_rate(const struct ccu *self,
 	return ccu_helper_get_rate_m(self, clk, rate, 0, 2);
 }
 
+static uint32_t
+r_ccu_round_r_apb1_rate(const struct ccu *self,
+                        const struct ccu_clock *clk,
+                        uint32_t parent_rate, uint32_t rate)
+{
+	return ccu_helper_round_rate_m(self, clk, parent_rate, rate, 2);
+}
+
+static int
+r_ccu_set_r_apb1_rate(const struct ccu *self,
+                      const struct ccu_clock *clk,
+                      uint32_t parent_rate, uint32_t rate)
+{
+	return ccu_helper_set_rate_m(self, clk, parent_rate, rate, 0, 2);
+}
+
 static DEFINE_FIXED_PARENT(r_ccu_get_r_apb1, r_ccu, CLK_R_APB1)
 static DEFINE_FIXED_PARENT(r_ccu_get_r_apb2, r_ccu, CLK_R_APB2)
 
@@ -90,6 +179,17 @@ r_ccu_get_module_parent(const struct ccu *self,
 	return &r_ccu_module_parents[bitfield_get(val, 24, 1)];
 }
 
+static int
+r_ccu_set_module_parent(const struct ccu *self,
+                        const struct ccu_clock *clk,
+                        const struct clock_handle *parent)
+{
+	return ccu_helper_set_parent_mux(self, clk, parent,
+	                                 r_ccu_module_parents,
+	                                 ARRAY_SIZE(r_ccu_module_parents),
+	                                 24, 1);
+}
+
 static const struct ccu_clock r_ccu_clocks[SUN50I_H6_R_CCU_CLOCKS] = {
 	[CLK_OSC16M] = {
 		.get_parent = ccu_get_null_parent,
@@ -106,6 +206,9 @@ static const struct ccu_clock r_ccu_clocks[SUN50I_H6_R_CCU_CLOCKS] = {
 	[CLK_AR100] = {
 		.get_parent = r_ccu_get_bus_parent,
 		.get_rate   = r_ccu_get_mp_rate,
+		.round_rate = r_ccu_round_bus_rate,
+		.set_parent = r_ccu_set_bus_parent,
+		.set_rate   = r_ccu_set_bus_rate,
 		.reg        = 0x0000,
 	},
 	[CLK_R_AHB] = {
@@ -115,11 +218,16 @@ static const struct ccu_clock r_ccu_clocks[SUN50I_H6_R_CCU_CLOCKS] = {
 	[CLK_R_APB1] = {
 		.get_parent = r_ccu_get_r_ahb,
 		.get_rate   = r_ccu_get_r_apb1_rate,
+		.round_rate = r_ccu_round_r_apb1_rate,
+		.set_rate   = r_ccu_set_r_apb1_rate,
 		.reg        = 0x000c,
 	},
 	[CLK_R_APB2] = {
 		.get_parent = r_ccu_get_bus_parent,
 		.get_rate   = r_ccu_get_mp_rate,
+		.round_rate = r_ccu_round_bus_rate,
+		.set_parent = r_ccu_set_bus_parent,
+		.set_rate   = r_ccu_set_bus_rate,
 		.reg        = 0x0010,
 	},
 	[CLK_BUS_R_PIO] = {
@@ -178,12 +286,18 @@ static const struct ccu_clock r_ccu_clocks[SUN50I_H6_R_CCU_CLOCKS] = {
 	[CLK_R_CIR] = {
 		.get_parent = r_ccu_get_module_parent,
 		.get_rate   = r_ccu_get_mp_rate,
+		.round_rate = r_ccu_round_mp_rate,
+		.set_parent = r_ccu_set_module_parent,
+		.set_rate   = r_ccu_set_mp_rate,
 		.reg        = 0x01c0,
 		.gate       = BITMAP_INDEX(0x01c0, 31),
 	},
 	[CLK_R_W1] = {
 		.get_parent = r_ccu_get_module_parent,
 		.get_rate   = r_ccu_get_mp_rate,
+		.round_rate = r_ccu_round_mp_rate,
+		.set_parent = r_ccu_set_module_parent,
+		.set_rate   = r_ccu_set_mp_rate,
 		.reg        = 0x01e0,
 		.gate       = BITMAP_INDEX(0x01e0, 31),
 	},
@@ -195,18 +309,51 @@ const struct ccu r_ccu = {
 		.drv   = &ccu_driver.drv,
 		.state = CLOCK_DEVICE_STATE_INIT(SUN50I_H6_R_CCU_CLOCKS),
 	},
-	.clocks = r_ccu_clocks,
-	.regs   = DEV_R_PRCM,
+	.clocks     = r_ccu_clocks,
+	.regs       = DEV_R_PRCM,
+	.num_clocks = SUN50I_H6_R_CCU_CLOCKS,
 };
 
+static_assert(SUN50I_H6_R_CCU_CLOCKS <= CCU_MAX_CLOCKS,
+              "Too many clocks for the unused clock bitmap");
+
+void
+r_ccu_set_busy(bool busy)
+{
+	uint32_t val = CPUS_CLK_REG_SLOW;
+
+	if (!CONFIG(R_CCU_GOVERNOR))
+		return;
+
+	/* Only switch to PLL_PERIPH0 while it is enabled and locked. */
+	if (busy && (mmio_read_32(PLL_PERIPH0_CTRL_REG) &
+	             PLL_PERIPH0_CTRL_LOCKED) == PLL_PERIPH0_CTRL_LOCKED)
+		val = CPUS_CLK_REG_FAST;
+	if (mmio_read_32(CPUS_CLK_REG) == val)
+		return;
+
+	if (val == CPUS_CLK_REG_FAST) {
+		/* Set R_APB1 to R_AHB/2 (100MHz) before raising R_AHB. */
+		mmio_write_32(R_APB1_CLK_REG, R_APB1_CLK_REG_DIV_M(1));
+		/* Set CPUS to PLL_PERIPH0/3 (200MHz). */
+		mmio_write_32(CPUS_CLK_REG, CPUS_CLK_REG_FAST);
+	} else {
+		/* Set CPUS to OSC16M/1 (16MHz). */
+		mmio_write_32(CPUS_CLK_REG, CPUS_CLK_REG_SLOW);
+		/* Set R_APB1 to R_AHB/1 (16MHz) after lowering R_AHB. */
+		mmio_write_32(R_APB1_CLK_REG, R_APB1_CLK_REG_DIV_M(0));
+	}
+	clock_invalidate_rates();
+
+	/* Delays and timers depend on the CPU clock rate. */
+	timer_update_rate();
+}
+
 void
 r_ccu_init(void)
 {
 	/* Set CPUS to OSC16M/1 (16MHz). */
-	mmio_write_32(CPUS_CLK_REG,
-	              CPUS_CLK_REG_CLK_SRC(2) |
-	              CPUS_CLK_REG_PRE_DIV(0) |
-	              CPUS_CLK_REG_DIV_P(0));
+	mmio_write_32(CPUS_CLK_REG, CPUS_CLK_REG_SLOW);
 
 	/* Set R_APB2 to OSC16M/1 (16MHz). */
 	mmio_write_32(R_APB2_CLK_REG,
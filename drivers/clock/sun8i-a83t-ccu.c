@@ -91,10 +91,14 @@ const struct ccu ccu = {
 		.drv   = &ccu_driver.drv,
 		.state = CLOCK_DEVICE_STATE_INIT(SUN8I_A83T_CCU_CLOCKS),
 	},
-	.clocks = ccu_clocks,
-	.regs   = DEV_CCU,
+	.clocks     = ccu_clocks,
+	.regs       = DEV_CCU,
+	.num_clocks = SUN8I_A83T_CCU_CLOCKS,
 };
 
+static_assert(SUN8I_A83T_CCU_CLOCKS <= CCU_MAX_CLOCKS,
+              "Too many clocks for the unused clock bitmap");
+
 void
 ccu_suspend(void)
 {
@@ -114,5 +118,7 @@ ccu_init(void)
 	              APB2_CLK_P(0) |
 	              APB2_CLK_M(0));
 
+	clock_invalidate_rates();
+
 	ccu_resume();
 }
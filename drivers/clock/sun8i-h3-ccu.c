@@ -34,6 +34,8 @@
 
 #define AHB2_CLK_SRC(n)   ((n) << 0)
 
+static DEFINE_FIXED_PARENT(ccu_get_osc24m, r_ccu, CLK_OSC24M)
+
 static DEFINE_FIXED_RATE(ccu_get_pll_periph0_rate, 600000000U)
 
 /*
@@ -104,6 +106,12 @@ static const struct ccu_clock ccu_clocks[SUN8I_H3_CCU_CLOCKS] = {
 		.get_rate   = ccu_get_parent_rate,
 		.gate       = BITMAP_INDEX(0x0068, 5),
 	},
+	[CLK_BUS_THS] = {
+		.get_parent = ccu_get_null_parent,
+		.get_rate   = ccu_get_parent_rate,
+		.gate       = BITMAP_INDEX(0x0068, 8),
+		.reset      = BITMAP_INDEX(0x02d0, 8),
+	},
 #if CONFIG(SERIAL_DEV_UART0)
 	[CLK_BUS_UART0] = {
 		.get_parent = ccu_get_apb2,
@@ -146,6 +154,12 @@ static const struct ccu_clock ccu_clocks[SUN8I_H3_CCU_CLOCKS] = {
 		.gate       = BITMAP_INDEX(0x015c, 31),
 		.reset      = BITMAP_INDEX(0x00fc, 31),
 	},
+	/* The divider is left at its reset value of 1. */
+	[CLK_THS] = {
+		.get_parent = ccu_get_osc24m,
+		.get_rate   = ccu_get_parent_rate,
+		.gate       = BITMAP_INDEX(0x0074, 31),
+	},
 };
 
 const struct ccu ccu = {
@@ -154,10 +168,14 @@ const struct ccu ccu = {
 		.drv   = &ccu_driver.drv,
 		.state = CLOCK_DEVICE_STATE_INIT(SUN8I_H3_CCU_CLOCKS),
 	},
-	.clocks = ccu_clocks,
-	.regs   = DEV_CCU,
+	.clocks     = ccu_clocks,
+	.regs       = DEV_CCU,
+	.num_clocks = SUN8I_H3_CCU_CLOCKS,
 };
 
+static_assert(SUN8I_H3_CCU_CLOCKS <= CCU_MAX_CLOCKS,
+              "Too many clocks for the unused clock bitmap");
+
 static const struct clock_handle pll_cpux = {
 	.dev = &ccu.dev,
 	.id  = CLK_PLL_CPUX,
@@ -184,6 +202,8 @@ ccu_suspend(void)
 	/* Set AHB2 to AHB1/1 (32kHz). */
 	mmio_write_32(DEV_CCU + AHB2_CFG_REG,
 	              AHB2_CLK_SRC(0));
+
+	clock_invalidate_rates();
 }
 
 void
@@ -207,6 +227,8 @@ ccu_resume(void)
 	/* Set AHB2 to PLL_PERIPH0/2 (300MHz). */
 	mmio_write_32(DEV_CCU + AHB2_CFG_REG,
 	              AHB2_CLK_SRC(1));
+
+	clock_invalidate_rates();
 }
 
 void
@@ -8,9 +8,11 @@
 #include <clock.h>
 #include <debug.h>
 #include <device.h>
+#include <error.h>
 #include <mmio.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <util.h>
 #include <clock/ccu.h>
 #include <platform/devices.h>
 #include <platform/prcm.h>
@@ -57,6 +59,48 @@ r_ccu_get_ar100_rate(const struct ccu *self,
 	return ccu_helper_get_rate_mp(self, clk, rate, 8, 5, 4, 2);
 }
 
+static uint32_t
+r_ccu_round_ar100_rate(const struct ccu *self,
+                       const struct ccu_clock *clk,
+                       uint32_t parent_rate, uint32_t rate)
+{
+	if (r_ccu_get_ar100_parent(self, clk) == &r_ccu_ar100_parents[2])
+		return ccu_helper_round_rate_mp(self, clk, parent_rate, rate,
+		                                5, 2);
+
+	return ccu_helper_round_rate_p(self, clk, parent_rate, rate, 2);
+}
+
+static int
+r_ccu_set_ar100_parent(const struct ccu *self,
+                       const struct ccu_clock *clk,
+                       const struct clock_handle *parent)
+{
+	int err;
+
+	err = ccu_helper_set_parent_mux(self, clk, parent, r_ccu_ar100_parents,
+	                                ARRAY_SIZE(r_ccu_ar100_parents),
+	                                16, 2);
+
+	/* Maintain the assumption made by r_ccu_get_ar100_rate(). */
+	if (!err && parent != &r_ccu_ar100_parents[2])
+		mmio_set_bitfield_32(self->regs + clk->reg, 8, 5, 0);
+
+	return err;
+}
+
+static int
+r_ccu_set_ar100_rate(const struct ccu *self,
+                     const struct ccu_clock *clk,
+                     uint32_t parent_rate, uint32_t rate)
+{
+	if (r_ccu_get_ar100_parent(self, clk) == &r_ccu_ar100_parents[2])
+		return ccu_helper_set_rate_mp(self, clk, parent_rate, rate,
+		                              8, 5, 4, 2);
+
+	return ccu_helper_set_rate_p(self, clk, parent_rate, rate, 4, 2);
+}
+
 static DEFINE_FIXED_PARENT(r_ccu_get_ar100, r_ccu, CLK_AR100)
 static DEFINE_FIXED_PARENT(r_ccu_get_ahb0, r_ccu, CLK_AHB0)
 
@@ -67,6 +111,22 @@ r_ccu_get_apb0_rate(const struct ccu *self,
 	return ccu_helper_get_rate_m(self, clk, rate, 0, 2);
 }
 
+static uint32_t
+r_ccu_round_apb0_rate(const struct ccu *self,
+                      const struct ccu_clock *clk,
+                      uint32_t parent_rate, uint32_t rate)
+{
+	return ccu_helper_round_rate_m(self, clk, parent_rate, rate, 2);
+}
+
+static int
+r_ccu_set_apb0_rate(const struct ccu *self,
+                    const struct ccu_clock *clk,
+                    uint32_t parent_rate, uint32_t rate)
+{
+	return ccu_helper_set_rate_m(self, clk, parent_rate, rate, 0, 2);
+}
+
 static DEFINE_FIXED_PARENT(r_ccu_get_apb0, r_ccu, CLK_APB0)
 
 static const struct clock_handle r_ccu_r_cir_parents[] = {
@@ -96,6 +156,34 @@ ccu_get_r_cir_rate(const struct ccu *self,
 	return ccu_helper_get_rate_mp(self, clk, rate, 0, 4, 16, 2);
 }
 
+static uint32_t
+ccu_round_r_cir_rate(const struct ccu *self,
+                     const struct ccu_clock *clk,
+                     uint32_t parent_rate, uint32_t rate)
+{
+	return ccu_helper_round_rate_mp(self, clk, parent_rate, rate, 4, 2);
+}
+
+static int
+ccu_set_r_cir_parent(const struct ccu *self,
+                     const struct ccu_clock *clk,
+                     const struct clock_handle *parent)
+{
+	return ccu_helper_set_parent_mux(self, clk, parent,
+	                                 r_ccu_r_cir_parents,
+	                                 ARRAY_SIZE(r_ccu_r_cir_parents),
+	                                 24, 1);
+}
+
+static int
+ccu_set_r_cir_rate(const struct ccu *self,
+                   const struct ccu_clock *clk,
+                   uint32_t parent_rate, uint32_t rate)
+{
+	return ccu_helper_set_rate_mp(self, clk, parent_rate, rate,
+	                              0, 4, 16, 2);
+}
+
 static const struct ccu_clock r_ccu_clocks[SUN8I_R_CCU_CLOCKS] = {
 	[CLK_OSC16M] = {
 		.get_parent = ccu_get_null_parent,
@@ -112,6 +200,9 @@ static const struct ccu_clock r_ccu_clocks[SUN8I_R_CCU_CLOCKS] = {
 	[CLK_AR100] = {
 		.get_parent = r_ccu_get_ar100_parent,
 		.get_rate   = r_ccu_get_ar100_rate,
+		.round_rate = r_ccu_round_ar100_rate,
+		.set_parent = r_ccu_set_ar100_parent,
+		.set_rate   = r_ccu_set_ar100_rate,
 		.reg        = 0x0000,
 	},
 	[CLK_AHB0] = {
@@ -121,6 +212,8 @@ static const struct ccu_clock r_ccu_clocks[SUN8I_R_CCU_CLOCKS] = {
 	[CLK_APB0] = {
 		.get_parent = r_ccu_get_ahb0,
 		.get_rate   = r_ccu_get_apb0_rate,
+		.round_rate = r_ccu_round_apb0_rate,
+		.set_rate   = r_ccu_set_apb0_rate,
 		.reg        = 0x000c,
 	},
 	[CLK_BUS_R_PIO] = {
@@ -169,6 +262,9 @@ static const struct ccu_clock r_ccu_clocks[SUN8I_R_CCU_CLOCKS] = {
 	[CLK_R_CIR] = {
 		.get_parent = ccu_get_r_cir_parent,
 		.get_rate   = ccu_get_r_cir_rate,
+		.round_rate = ccu_round_r_cir_rate,
+		.set_parent = ccu_set_r_cir_parent,
+		.set_rate   = ccu_set_r_cir_rate,
 		.reg        = 0x0054,
 		.gate       = BITMAP_INDEX(0x0054, 31),
 	},
@@ -180,10 +276,14 @@ const struct ccu r_ccu = {
 		.drv   = &ccu_driver.drv,
 		.state = CLOCK_DEVICE_STATE_INIT(SUN8I_R_CCU_CLOCKS),
 	},
-	.clocks = r_ccu_clocks,
-	.regs   = DEV_R_PRCM,
+	.clocks     = r_ccu_clocks,
+	.regs       = DEV_R_PRCM,
+	.num_clocks = SUN8I_R_CCU_CLOCKS,
 };
 
+static_assert(SUN8I_R_CCU_CLOCKS <= CCU_MAX_CLOCKS,
+              "Too many clocks for the unused clock bitmap");
+
 void
 r_ccu_init(void)
 {
@@ -3,14 +3,36 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <clock.h>
 #include <css.h>
 #include <debug.h>
+#include <regulator.h>
 #include <scpi_protocol.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <util.h>
 
 #include "css.h"
 
+/** Whether a client has selected an OPP, so it expects DVFS to work. */
+static bool    css_dvfs_used;
+/** Whether the CPU clocks are held at their slowest OPP. */
+static bool    css_throttled;
+/** The OPP requested by the client for each cluster while throttled. */
+static uint8_t css_requested_opp[MAX_CLUSTERS];
+/** The number of OPPs usable at each cluster's present supply voltage. */
+static uint8_t css_opp_limit[MAX_CLUSTERS];
+
+static const struct css_dvfs_domain *
+css_get_dvfs_domain_checked(uint32_t cluster)
+{
+	if (!CONFIG(DVFS) || cluster >= css_get_cluster_count())
+		return NULL;
+
+	return css_get_dvfs_domain(cluster);
+}
+
 /*
  * These generic functions provide a safe default implementation of the CSS
  * API, so platforms may implement power domain control functions
@@ -36,6 +58,62 @@ css_get_core_count(uint32_t cluster UNUSED)
 	return MAX_CORES_PER_CLUSTER;
 }
 
+/**
+ * Generic implementation used when no platform support is available.
+ */
+const struct css_dvfs_domain *WEAK
+css_get_dvfs_domain(uint32_t cluster UNUSED)
+{
+	return NULL;
+}
+
+uint32_t
+css_get_dvfs_count(void)
+{
+	uint32_t count = 0;
+
+	while (css_get_dvfs_domain_checked(count))
+		++count;
+
+	return count;
+}
+
+int
+css_get_opp(uint32_t cluster, uint32_t *opp)
+{
+	const struct css_dvfs_domain *domain;
+	uint32_t rate;
+
+	if (!(domain = css_get_dvfs_domain_checked(cluster)))
+		return SCPI_E_PARAM;
+
+	rate = clock_get_rate(&domain->clock);
+
+	*opp = 0;
+	for (uint32_t i = 1; i < css_opp_limit[cluster]; ++i) {
+		if (domain->opps[i].rate <= rate)
+			*opp = i;
+	}
+
+	return SCPI_OK;
+}
+
+int
+css_get_opps(uint32_t cluster, const struct css_opp **opps,
+             uint32_t *count, uint32_t *latency)
+{
+	const struct css_dvfs_domain *domain;
+
+	if (!(domain = css_get_dvfs_domain_checked(cluster)))
+		return SCPI_E_PARAM;
+
+	*opps    = domain->opps;
+	*count   = css_opp_limit[cluster];
+	*latency = domain->latency;
+
+	return SCPI_OK;
+}
+
 int
 css_get_power_state(uint32_t cluster, uint32_t *cluster_state,
                     uint32_t *online_cores)
@@ -56,6 +134,28 @@ css_get_power_state(uint32_t cluster, uint32_t *cluster_state,
 	return SCPI_OK;
 }
 
+/**
+ * Generic implementation used when no platform support is available. Report
+ * every core as idle, since there is no way to wait for it.
+ */
+bool WEAK
+css_get_core_wfi(uint32_t cluster UNUSED, uint32_t core UNUSED)
+{
+	return true;
+}
+
+bool
+css_core_in_wfi(uint32_t cluster, uint32_t core)
+{
+	/* Invalid indexes are reported by css_set_power_state(). */
+	if (cluster >= css_get_cluster_count())
+		return true;
+	if (core >= css_get_core_count(cluster))
+		return true;
+
+	return css_get_core_wfi(cluster, core);
+}
+
 /**
  * Generic implementation used when no platform support is available.
  */
@@ -101,6 +201,108 @@ css_set_core_state(uint32_t cluster UNUSED, uint32_t core UNUSED,
 	return SCPI_E_SUPPORT;
 }
 
+int
+css_set_opp(uint32_t cluster, uint32_t opp)
+{
+	const struct css_dvfs_domain *domain;
+
+	if (!(domain = css_get_dvfs_domain_checked(cluster)))
+		return SCPI_E_PARAM;
+	if (opp >= css_opp_limit[cluster])
+		return SCPI_E_RANGE;
+
+	css_dvfs_used = true;
+
+	/* Defer the change until the throttle is released. */
+	if (css_throttled) {
+		css_requested_opp[cluster] = opp;
+		return SCPI_OK;
+	}
+
+	/* The supply voltage already allows every OPP within the limit. */
+	if (clock_set_rate(&domain->clock, domain->opps[opp].rate))
+		return SCPI_E_DEVICE;
+
+	return SCPI_OK;
+}
+
+bool
+css_set_throttle(bool throttle)
+{
+	const struct css_dvfs_domain *domain;
+	uint32_t opp;
+
+	if (throttle == css_throttled)
+		return css_throttled;
+
+	if (!throttle) {
+		css_throttled = false;
+
+		/* Restore the last OPP requested by the client. */
+		for (uint32_t i = 0; css_get_dvfs_domain_checked(i); ++i)
+			css_set_opp(i, css_requested_opp[i]);
+
+		return false;
+	}
+
+	/* Do not change a clock that the client manages by other means. */
+	if (!css_dvfs_used)
+		return false;
+
+	for (uint32_t i = 0; (domain = css_get_dvfs_domain_checked(i)); ++i) {
+		css_get_opp(i, &opp);
+		css_requested_opp[i] = opp;
+
+		/*
+		 * Only change the clock, since the current voltage is always
+		 * sufficient for a lower rate. This keeps the reaction time as
+		 * short as possible.
+		 */
+		clock_set_rate(&domain->clock, domain->opps[0].rate);
+	}
+
+	css_throttled = true;
+
+	return true;
+}
+
+void
+css_update_opp_limits(void)
+{
+	const struct css_dvfs_domain *domain;
+	uint32_t voltage;
+
+	for (uint32_t i = 0; (domain = css_get_dvfs_domain_checked(i)); ++i) {
+		uint8_t count = 0;
+
+		/* Without a known voltage, no OPP is safe to select. */
+		if (!regulator_get_voltage(domain->supply, &voltage)) {
+			while (count < domain->opp_count &&
+			       domain->opps[count].voltage <= voltage)
+				++count;
+		}
+		css_opp_limit[i] = count;
+	}
+}
+
+void
+css_restore_opp_limits(void)
+{
+	const struct css_dvfs_domain *domain;
+	uint32_t rate;
+
+	for (uint32_t i = 0; (domain = css_get_dvfs_domain_checked(i)); ++i) {
+		uint8_t count = 0;
+
+		/* The CPUs are running, so their present OPP is valid. */
+		rate = clock_get_rate(&domain->clock);
+		while (count < domain->opp_count &&
+		       domain->opps[count].rate <= rate)
+			++count;
+		css_opp_limit[i] = count;
+	}
+}
+
 int
 css_set_power_state(uint32_t cluster, uint32_t core, uint32_t core_state,
                     uint32_t cluster_state, uint32_t css_state)
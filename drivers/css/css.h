@@ -6,6 +6,9 @@
 #ifndef CSS_PRIVATE_H
 #define CSS_PRIVATE_H
 
+#include <clock.h>
+#include <css.h>
+#include <regulator.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <platform/css.h>
@@ -16,6 +19,19 @@ struct power_state {
 	uint8_t css;
 };
 
+struct css_dvfs_domain {
+	/** The clock source for the CPUs in the cluster. */
+	struct clock_handle            clock;
+	/** The power supply for the CPUs in the cluster. */
+	const struct regulator_handle *supply;
+	/** The table of OPPs, sorted by increasing rate. */
+	const struct css_opp          *opps;
+	/** The number of OPPs in the table. */
+	uint8_t                        opp_count;
+	/** The worst-case OPP transition latency, in microseconds. */
+	uint16_t                       latency;
+};
+
 extern struct power_state power_state;
 
 /**
@@ -27,6 +43,23 @@ extern struct power_state power_state;
  */
 uint32_t css_get_core_count(uint32_t cluster) ATTRIBUTE(const);
 
+/**
+ * Get the DVFS configuration of a cluster.
+ *
+ * @param cluster The index of the cluster.
+ * @return        The DVFS configuration, or NULL if DVFS is unsupported.
+ */
+const struct css_dvfs_domain *css_get_dvfs_domain(uint32_t cluster);
+
+/**
+ * Determine if a CPU core is in the WFI state, so it can be turned off
+ * without waiting.
+ *
+ * @param cluster The index of the cluster.
+ * @param core    The index of the core within the cluster.
+ */
+bool css_get_core_wfi(uint32_t cluster, uint32_t core);
+
 /**
  * Set the state of the compute subsystem (CSS). This state must not be
  * numbered higher than the lowest cluster state in the CSS.
@@ -3,10 +3,14 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <css.h>
 #include <delay.h>
 #include <mmio.h>
+#include <regulator_list.h>
 #include <scpi_protocol.h>
 #include <stdint.h>
+#include <util.h>
+#include <clock/ccu.h>
 #include <platform/cpucfg.h>
 #include <platform/prcm.h>
 
@@ -15,6 +19,47 @@
 /* Reset Vector Base Address. */
 static uint32_t rvba;
 
+/*
+ * The OPP voltages are only known to be correct for the A64 powered by
+ * an AXP803, which is the reference design.
+ */
+#if CONFIG(DVFS) && CONFIG(SOC_A64) && CONFIG(REGULATOR_AXP803)
+static const struct css_opp css_opps[] = {
+	{  648000000, 1040 },
+	{  816000000, 1100 },
+	{  912000000, 1120 },
+	{  960000000, 1160 },
+	{ 1008000000, 1200 },
+	{ 1056000000, 1240 },
+	{ 1104000000, 1260 },
+	{ 1152000000, 1300 },
+};
+
+static const struct css_dvfs_domain css_dvfs_domain = {
+	.clock     = {
+		.dev = &ccu.dev,
+		.id  = CLK_PLL_CPUX,
+	},
+	.supply    = &cpu_supply,
+	.opps      = css_opps,
+	.opp_count = ARRAY_SIZE(css_opps),
+	.latency   = 244,
+};
+
+const struct css_dvfs_domain *
+css_get_dvfs_domain(uint32_t cluster UNUSED)
+{
+	return &css_dvfs_domain;
+}
+#endif
+
+bool
+css_get_core_wfi(uint32_t cluster UNUSED, uint32_t core)
+{
+	return mmio_get_32(C0_CPU_STATUS_REG,
+	                   C0_CPU_STATUS_REG_STANDBYWFI(core));
+}
+
 int
 css_set_css_state(uint32_t state UNUSED)
 {
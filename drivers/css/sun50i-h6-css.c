@@ -3,9 +3,13 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <css.h>
 #include <mmio.h>
+#include <regulator_list.h>
 #include <scpi_protocol.h>
 #include <stdint.h>
+#include <util.h>
+#include <clock/ccu.h>
 #include <platform/cpucfg.h>
 
 #include "css.h"
@@ -13,6 +17,47 @@
 /* Reset Vector Base Address. */
 static uint32_t rvba;
 
+/*
+ * These are the OPPs for the slowest speed bin, which uses the highest
+ * voltages, so they are safe for every chip. The voltages are only known
+ * to be correct for the H6 powered by an AXP805.
+ */
+#if CONFIG(DVFS) && CONFIG(REGULATOR_AXP805)
+static const struct css_opp css_opps[] = {
+	{  480000000,  880 },
+	{  720000000,  880 },
+	{  816000000,  880 },
+	{  888000000,  940 },
+	{ 1080000000, 1060 },
+	{ 1320000000, 1160 },
+	{ 1488000000, 1160 },
+};
+
+static const struct css_dvfs_domain css_dvfs_domain = {
+	.clock     = {
+		.dev = &ccu.dev,
+		.id  = CLK_PLL_CPUX,
+	},
+	.supply    = &cpu_supply,
+	.opps      = css_opps,
+	.opp_count = ARRAY_SIZE(css_opps),
+	.latency   = 244,
+};
+
+const struct css_dvfs_domain *
+css_get_dvfs_domain(uint32_t cluster UNUSED)
+{
+	return &css_dvfs_domain;
+}
+#endif
+
+bool
+css_get_core_wfi(uint32_t cluster UNUSED, uint32_t core)
+{
+	return mmio_get_32(C0_CPU_STATUS_REG,
+	                   C0_CPU_STATUS_REG_STANDBYWFI(core));
+}
+
 int
 css_set_css_state(uint32_t state UNUSED)
 {
@@ -11,6 +11,12 @@
 
 #include "css.h"
 
+bool
+css_get_core_wfi(uint32_t cluster UNUSED, uint32_t core)
+{
+	return mmio_get_32(CPUn_STATUS_REG(core), CPUn_STATUS_REG_STANDBYWFI);
+}
+
 int
 css_set_css_state(uint32_t state UNUSED)
 {
@@ -31,6 +31,22 @@ irq_poll_eint(void)
 	return pending;
 }
 
+void WEAK
+irq_disable(uint32_t irq UNUSED)
+{
+}
+
+void WEAK
+irq_enable(uint32_t irq UNUSED)
+{
+}
+
+uint32_t WEAK
+irq_handle(void)
+{
+	return 0;
+}
+
 uint32_t WEAK
 irq_needs_avcc(void)
 {
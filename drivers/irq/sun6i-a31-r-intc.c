@@ -4,6 +4,7 @@
  */
 
 #include <irq.h>
+#include <limits.h>
 #include <mmio.h>
 #include <stdint.h>
 #include <util.h>
@@ -59,6 +60,56 @@ static const uint32_t mux_needs_vdd_sys[NUM_MUX_REGS] = {
 #endif
 };
 
+/*
+ * The IRQ lines enabled by this firmware. The rich OS programs the same EN
+ * and MASK registers for the lines it owns (such as the NMI), so the firmware
+ * only touches these bits and leaves every other line as it found it.
+ */
+static uint32_t irq_owned[NUM_IRQ_REGS];
+
+void
+irq_disable(uint32_t irq)
+{
+	uint32_t bit = BIT(irq % WORD_BIT);
+	uint32_t reg = irq / WORD_BIT;
+
+	mmio_clr_32(DEV_R_INTC + INTC_IRQ_EN_REG(reg), bit);
+	mmio_write_32(DEV_R_INTC + INTC_IRQ_PEND_REG(reg), bit);
+	irq_owned[reg] &= ~bit;
+}
+
+void
+irq_enable(uint32_t irq)
+{
+	uint32_t bit = BIT(irq % WORD_BIT);
+	uint32_t reg = irq / WORD_BIT;
+
+	irq_owned[reg] |= bit;
+
+	/* Level-triggered IRQs will become pending again immediately. */
+	mmio_write_32(DEV_R_INTC + INTC_IRQ_PEND_REG(reg), bit);
+	mmio_set_32(DEV_R_INTC + INTC_IRQ_EN_REG(reg), bit);
+	mmio_clr_32(DEV_R_INTC + INTC_IRQ_MASK_REG(reg), bit);
+}
+
+uint32_t
+irq_handle(void)
+{
+	uint32_t foreign = 0;
+
+	for (int i = 0; i < NUM_IRQ_REGS; ++i) {
+		uint32_t pending =
+			mmio_read_32(DEV_R_INTC + INTC_IRQ_PEND_REG(i));
+
+		if (pending & irq_owned[i])
+			mmio_set_32(DEV_R_INTC + INTC_IRQ_MASK_REG(i),
+			            pending & irq_owned[i]);
+		foreign |= pending & ~irq_owned[i];
+	}
+
+	return foreign;
+}
+
 uint32_t
 irq_needs_avcc(void)
 {
@@ -24,8 +24,19 @@
 #define RSB_ADDRESS   (0x3a << 16 | 0x745)
 #endif
 
+/* Status, ADC, and self-clearing control registers. */
+static const struct regmap_range axp20x_volatile_ranges[] = {
+	{ 0x00, 0x02 },
+	{ 0x31, 0x32 },
+	{ 0x48, 0x4f },
+	{ 0x56, 0x7f },
+};
+
+/* Registers above this are not used by the firmware outside of debugging. */
+DEFINE_REGMAP_CACHE(axp20x_cache, 0x9f, axp20x_volatile_ranges);
+
 static int
-axp20x_probe(const struct device *dev)
+axp20x_identify(const struct device *dev)
 {
 	const struct regmap_device *self = to_regmap_device(dev);
 	uint8_t reg;
@@ -48,19 +59,37 @@ err_release:
 	return err;
 }
 
+static int
+axp20x_probe(const struct device *dev)
+{
+	int err;
+
+	/* If the bus is unreliable at its configured rate, slow it down. */
+	if ((err = axp20x_identify(dev)) && CONFIG(RSB) &&
+	    !sunxi_rsb_reduce_rate()) {
+		/* Ensure the controller is reprobed at the new rate. */
+		device_release_if_idle(&r_rsb.dev);
+		err = axp20x_identify(dev);
+	}
+
+	return err;
+}
+
 static const struct driver axp20x_driver = {
-	.probe   = axp20x_probe,
-	.release = regmap_device_release,
+	.probe             = axp20x_probe,
+	.release           = regmap_device_release,
+	.autosuspend_delay = REGMAP_AUTOSUSPEND_DELAY,
 };
 
 const struct regmap_device axp20x = {
 	.dev = {
 		.name  = "axp20x",
 		.drv   = &axp20x_driver,
-		.state = DEVICE_STATE_INIT,
+		.state = DEVICE_AUTOSUSPEND_STATE_INIT,
 	},
 	.map = {
-		.dev = CONFIG(RSB) ? &r_rsb.dev : &r_i2c.dev,
-		.id  = CONFIG(RSB) ? RSB_ADDRESS : I2C_ADDRESS,
+		.dev   = CONFIG(RSB) ? &r_rsb.dev : &r_i2c.dev,
+		.cache = REGMAP_CACHE(axp20x_cache),
+		.id    = CONFIG(RSB) ? RSB_ADDRESS : I2C_ADDRESS,
 	},
 };
@@ -97,6 +97,7 @@ static int
 sunxi_msgbox_probe(const struct device *dev)
 {
 	const struct simple_device *self = to_simple_device(dev);
+	uint32_t rx_irqs = 0;
 	int err;
 
 	if ((err = simple_device_probe(dev)))
@@ -110,19 +111,32 @@ sunxi_msgbox_probe(const struct device *dev)
 	for (uint8_t chan = 0; chan < SUNXI_MSGBOX_CHANS; chan += 2) {
 		while (sunxi_msgbox_peek_data(dev, chan))
 			mmio_read_32(self->regs + MSG_DATA_REG(chan));
+		rx_irqs |= RX_IRQ(chan);
 	}
 
-	/* Disable and clear all IRQ. */
+	/* Clear all IRQs, and enable only the RX IRQs. */
 	mmio_write_32(self->regs + IRQ_EN_REG, 0);
 	mmio_write_32(self->regs + IRQ_STAT_REG, GENMASK(15, 0));
+	mmio_write_32(self->regs + IRQ_EN_REG, rx_irqs);
 
 	return SUCCESS;
 }
 
+static void
+sunxi_msgbox_release(const struct device *dev)
+{
+	const struct simple_device *self = to_simple_device(dev);
+
+	/* Disable all IRQs. */
+	mmio_write_32(self->regs + IRQ_EN_REG, 0);
+
+	simple_device_release(dev);
+}
+
 static const struct msgbox_driver sunxi_msgbox_driver = {
 	.drv = {
 		.probe   = sunxi_msgbox_probe,
-		.release = simple_device_release,
+		.release = sunxi_msgbox_release,
 	},
 	.ops = {
 		.ack_rx       = sunxi_msgbox_ack_rx,
@@ -12,18 +12,20 @@
 
 #define PIN_FUNCTION_REG 0x8f
 
+static const struct regmap_seq_step axp803_suspend_seq[] = {
+	/* Enable resume, allow IRQs during suspend. */
+	{ WAKEUP_CTRL_REG, BIT(4) | BIT(3), BIT(4) | BIT(3) },
+	/* Remember previous voltages when waking up from suspend. */
+	{ PIN_FUNCTION_REG, BIT(1), BIT(1) },
+};
+
 static int
 axp803_pmic_suspend(const struct device *dev)
 {
 	const struct axp20x_pmic *self = to_axp20x_pmic(dev);
-	int err;
 
-	/* Remember previous voltages when waking up from suspend. */
-	if ((err = regmap_set_bits(self->map, PIN_FUNCTION_REG, BIT(1))))
-		return err;
-
-	/* Enable resume, allow IRQs during suspend. */
-	return regmap_set_bits(self->map, WAKEUP_CTRL_REG, BIT(4) | BIT(3));
+	return regmap_run_sequence(self->map, axp803_suspend_seq,
+	                           ARRAY_SIZE(axp803_suspend_seq));
 }
 
 static const struct pmic_driver axp803_pmic_driver = {
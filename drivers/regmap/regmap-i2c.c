@@ -6,6 +6,7 @@
 #include <device.h>
 #include <error.h>
 #include <intrusive.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "regmap-i2c.h"
@@ -35,7 +36,7 @@ regmap_i2c_prepare(const struct regmap *map)
 		goto abort;
 
 	/* Read data to avoid putting the device in an inconsistent state. */
-	if (ops->read(map, &dummy))
+	if (ops->read(map, &dummy, false))
 		goto abort;
 
 abort:
@@ -46,7 +47,8 @@ abort:
 }
 
 int
-regmap_i2c_read(const struct regmap *map, uint8_t reg, uint8_t *val)
+regmap_i2c_read(const struct regmap *map, uint8_t reg, uint8_t *vals,
+                uint8_t count)
 {
 	const struct regmap_i2c_driver_ops *ops = regmap_i2c_ops_for(map);
 	int err;
@@ -63,9 +65,12 @@ regmap_i2c_read(const struct regmap *map, uint8_t reg, uint8_t *val)
 	if ((err = ops->start(map, I2C_READ)))
 		goto abort;
 
-	/* Read the register value. */
-	if ((err = ops->read(map, val)))
-		goto abort;
+	/* Read the register values, relying on address auto-increment.
+	 * Acknowledge every byte except the last. */
+	for (uint8_t i = 0; i < count; ++i) {
+		if ((err = ops->read(map, &vals[i], i + 1 < count)))
+			goto abort;
+	}
 
 abort:
 	/* Finish the transaction. */
@@ -75,7 +80,8 @@ abort:
 }
 
 int
-regmap_i2c_write(const struct regmap *map, uint8_t reg, uint8_t val)
+regmap_i2c_write(const struct regmap *map, uint8_t reg,
+                 const uint8_t *vals, uint8_t count)
 {
 	const struct regmap_i2c_driver_ops *ops = regmap_i2c_ops_for(map);
 	int err;
@@ -88,9 +94,11 @@ regmap_i2c_write(const struct regmap *map, uint8_t reg, uint8_t val)
 	if ((err = ops->write(map, reg)))
 		goto abort;
 
-	/* Write the register value. */
-	if ((err = ops->write(map, val)))
-		goto abort;
+	/* Write the register values, relying on address auto-increment. */
+	for (uint8_t i = 0; i < count; ++i) {
+		if ((err = ops->write(map, vals[i])))
+			goto abort;
+	}
 
 abort:
 	/* Finish the transaction. */
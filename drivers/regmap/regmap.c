@@ -3,14 +3,25 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <bitmap.h>
 #include <device.h>
 #include <error.h>
 #include <intrusive.h>
 #include <regmap.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "regmap.h"
 
+/* The most registers updated by one bulk transfer in a sequence. */
+#define REGMAP_SEQ_SPAN 4
+
+/** Whether regmap caches may be used. */
+static bool     regmap_cache_enabled;
+
+/** Incremented to invalidate the contents of every regmap cache. */
+static uint32_t regmap_cache_generation;
+
 /**
  * Get the ops for the regmap device.
  */
@@ -23,6 +34,57 @@ regmap_ops_for(const struct regmap *map)
 	return &drv->ops;
 }
 
+/**
+ * Get the cache for a register, or NULL if the register is not cacheable.
+ * Stale cache contents are discarded.
+ */
+static const struct regmap_cache *
+regmap_cache_for(const struct regmap *map, uint8_t reg)
+{
+	const struct regmap_cache *cache = map->cache;
+
+	if (!CONFIG(REGMAP_CACHE) || !cache || !regmap_cache_enabled ||
+	    reg > cache->max_reg)
+		return NULL;
+
+	for (uint8_t i = 0; i < cache->volatile_count; ++i) {
+		const struct regmap_range *range = &cache->volatile_ranges[i];
+
+		if (reg >= range->first && reg <= range->last)
+			return NULL;
+	}
+
+	if (*cache->generation != regmap_cache_generation) {
+		for (uint8_t i = 0; i <= cache->max_reg / 32; ++i)
+			cache->valid[i] = 0;
+		*cache->generation = regmap_cache_generation;
+	}
+
+	return cache;
+}
+
+static bool
+regmap_cache_hit(const struct regmap_cache *cache, uint8_t reg)
+{
+	return cache && bitmap_get((uintptr_t)cache->valid, reg);
+}
+
+static void
+regmap_cache_store(const struct regmap_cache *cache, uint8_t reg,
+                   uint8_t val)
+{
+	cache->values[reg] = val;
+	bitmap_set((uintptr_t)cache->valid, reg);
+}
+
+void
+regmap_cache_set_enabled(bool enabled)
+{
+	regmap_cache_enabled = enabled;
+	if (!enabled)
+		++regmap_cache_generation;
+}
+
 int
 regmap_get(const struct regmap *map)
 {
@@ -52,27 +114,146 @@ regmap_put(const struct regmap *map)
 int
 regmap_read(const struct regmap *map, uint8_t reg, uint8_t *val)
 {
-	return regmap_ops_for(map)->read(map, reg, val);
+	const struct regmap_cache *cache = regmap_cache_for(map, reg);
+	int err;
+
+	if (regmap_cache_hit(cache, reg)) {
+		*val = cache->values[reg];
+		return SUCCESS;
+	}
+
+	if ((err = regmap_ops_for(map)->read(map, reg, val, 1)))
+		return err;
+
+	if (cache)
+		regmap_cache_store(cache, reg, *val);
+
+	return SUCCESS;
 }
 
 int
 regmap_write(const struct regmap *map, uint8_t reg, uint8_t val)
 {
-	return regmap_ops_for(map)->write(map, reg, val);
+	const struct regmap_cache *cache = regmap_cache_for(map, reg);
+	int err;
+
+	if (regmap_cache_hit(cache, reg) && cache->values[reg] == val)
+		return SUCCESS;
+
+	if ((err = regmap_ops_for(map)->write(map, reg, &val, 1))) {
+		/* The register contents are now unknown. */
+		if (cache)
+			bitmap_clear((uintptr_t)cache->valid, reg);
+		return err;
+	}
+
+	if (cache)
+		regmap_cache_store(cache, reg, val);
+
+	return SUCCESS;
+}
+
+int
+regmap_bulk_read(const struct regmap *map, uint8_t reg, uint8_t *vals,
+                 uint8_t count)
+{
+	const struct regmap_cache *cache;
+	uint8_t i;
+	int err;
+
+	/* Skip the transfer if every register is cached. */
+	for (i = 0; i < count; ++i) {
+		cache = regmap_cache_for(map, reg + i);
+		if (!regmap_cache_hit(cache, reg + i))
+			break;
+		vals[i] = cache->values[reg + i];
+	}
+	if (i == count)
+		return SUCCESS;
+
+	if ((err = regmap_ops_for(map)->read(map, reg, vals, count)))
+		return err;
+
+	for (i = 0; i < count; ++i) {
+		if ((cache = regmap_cache_for(map, reg + i)))
+			regmap_cache_store(cache, reg + i, vals[i]);
+	}
+
+	return SUCCESS;
+}
+
+int
+regmap_bulk_write(const struct regmap *map, uint8_t reg, const uint8_t *vals,
+                  uint8_t count)
+{
+	const struct regmap_cache *cache;
+	int err;
+
+	err = regmap_ops_for(map)->write(map, reg, vals, count);
+
+	for (uint8_t i = 0; i < count; ++i) {
+		if (!(cache = regmap_cache_for(map, reg + i)))
+			continue;
+		/* On failure, the register contents are now unknown. */
+		if (err)
+			bitmap_clear((uintptr_t)cache->valid, reg + i);
+		else
+			regmap_cache_store(cache, reg + i, vals[i]);
+	}
+
+	return err;
 }
 
 int
 regmap_update_bits(const struct regmap *map, uint8_t reg, uint8_t mask,
                    uint8_t val)
 {
-	const struct regmap_driver_ops *ops = regmap_ops_for(map);
 	uint8_t tmp;
 	int err;
 
-	if ((err = ops->read(map, reg, &tmp)))
+	if ((err = regmap_read(map, reg, &tmp)))
 		return err;
 
-	return ops->write(map, reg, tmp ^ ((val ^ tmp) & mask));
+	return regmap_write(map, reg, tmp ^ ((val ^ tmp) & mask));
+}
+
+int
+regmap_run_sequence(const struct regmap *map,
+                    const struct regmap_seq_step *seq, uint8_t count)
+{
+	uint8_t vals[REGMAP_SEQ_SPAN];
+	int err;
+
+	for (uint8_t i = 0, j; i < count; i = j) {
+		uint8_t first   = seq[i].reg;
+		uint8_t span    = 1;
+		bool    changed = false;
+
+		/* Collect the steps that modify adjacent registers. */
+		for (j = i + 1; j < count; ++j) {
+			if (seq[j].reg < seq[j - 1].reg ||
+			    seq[j].reg > seq[j - 1].reg + 1 ||
+			    seq[j].reg - first >= REGMAP_SEQ_SPAN)
+				break;
+			span = seq[j].reg - first + 1;
+		}
+
+		if ((err = regmap_bulk_read(map, first, vals, span)))
+			return err;
+		for (uint8_t k = i; k < j; ++k) {
+			uint8_t *val = &vals[seq[k].reg - first];
+			uint8_t  old = *val;
+
+			*val     = old ^ ((seq[k].val ^ old) & seq[k].mask);
+			changed |= *val != old;
+		}
+		if (!changed)
+			continue;
+		if ((err = regmap_bulk_write(map, first, vals, span)))
+			return err;
+	}
+
+	return SUCCESS;
 }
 
 int
@@ -12,8 +12,10 @@
 
 struct regmap_driver_ops {
 	int (*prepare)(const struct regmap *map);
-	int (*read)(const struct regmap *map, uint8_t reg, uint8_t *val);
-	int (*write)(const struct regmap *map, uint8_t reg, uint8_t val);
+	int (*read)(const struct regmap *map, uint8_t reg, uint8_t *vals,
+	            uint8_t count);
+	int (*write)(const struct regmap *map, uint8_t reg,
+	             const uint8_t *vals, uint8_t count);
 };
 
 struct regmap_driver {
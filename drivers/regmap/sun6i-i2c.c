@@ -3,16 +3,21 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
-#include <delay.h>
+#include <clock.h>
+#include <cpu.h>
 #include <error.h>
+#include <irq.h>
 #include <mmio.h>
 #include <regmap.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <timeout.h>
 #include <util.h>
 #include <clock/ccu.h>
 #include <gpio/sunxi-gpio.h>
 #include <regmap/sun6i-i2c.h>
 #include <platform/devices.h>
+#include <platform/irq.h>
 
 #include "regmap-i2c.h"
 
@@ -26,6 +31,13 @@
 #define I2C_EFR_REG   0x1c
 #define I2C_LCR_REG   0x20
 
+#define I2C_RATE      400000 /* Hz */
+
+/* One bus cycle is 2.5μs. Allow some margin for clock stretching. */
+#define CYCLE_TIMEOUT 10 /* us */
+/* Eight data bits, one ACK, and one extra cycle. */
+#define BYTE_TIMEOUT  (10 * CYCLE_TIMEOUT)
+
 enum {
 	START_COND_TX        = 0x08,
 	START_COND_TX_REPEAT = 0x10,
@@ -43,13 +55,12 @@ enum {
 static int
 sun6i_i2c_wait_idle(const struct simple_device *self)
 {
-	/* With a single master on the bus, this should only take one cycle. */
-	int timeout = 2;
+	uint64_t timeout = timeout_set(CYCLE_TIMEOUT);
 
+	/* With a single master on the bus, this should only take one cycle.
+	 * No IRQ is raised when the stop condition completes. */
 	while (mmio_read_32(self->regs + I2C_CTRL_REG) & (BIT(5) | BIT(4))) {
-		/* 10μs is one 100kHz bus cycle. */
-		udelay(10);
-		if (timeout-- == 0)
+		if (timeout_expired(timeout))
 			return EIO;
 	}
 
@@ -59,52 +70,72 @@ sun6i_i2c_wait_idle(const struct simple_device *self)
 	return SUCCESS;
 }
 
-static int
-sun6i_i2c_wait_start(const struct simple_device *self)
-{
-	/* With a single master on the bus, this should only take one cycle. */
-	int timeout = 2;
-
-	while (mmio_read_32(self->regs + I2C_CTRL_REG) & BIT(5)) {
-		/* 10μs is one 100kHz bus cycle. */
-		udelay(10);
-		if (timeout-- == 0)
-			return EIO;
-	}
-
-	return SUCCESS;
-}
-
 static int
 sun6i_i2c_wait_state(const struct simple_device *self, uint8_t state)
 {
-	/* Wait for up to 8 transfer cycles, one ACK, and one extra cycle. */
-	int timeout = 10;
-
+	uint64_t timeout = timeout_set(BYTE_TIMEOUT);
+	int err = SUCCESS;
+
+	/*
+	 * Doze until the controller raises its IRQ for the state change. If
+	 * IRQs are enabled, the handler masks the IRQ; either way, it will
+	 * end doze mode. Other IRQs may end doze mode early, so recheck the
+	 * flag after waking up.
+	 */
+	irq_enable(IRQ_R_I2C);
 	while (!(mmio_read_32(self->regs + I2C_CTRL_REG) & BIT(3))) {
-		/* 10μs is one 100kHz bus cycle. */
-		udelay(10);
-		if (timeout-- == 0)
-			return EIO;
+		if (timeout_expired(timeout)) {
+			err = EIO;
+			break;
+		}
+		cpu_doze(timeout);
 	}
+	irq_disable(IRQ_R_I2C);
 
-	if (mmio_read_32(self->regs + I2C_STAT_REG) != state)
+	if (err || mmio_read_32(self->regs + I2C_STAT_REG) != state)
 		return EIO;
 
 	return SUCCESS;
 }
 
+static void
+sun6i_i2c_set_rate(const struct simple_device *self, uint32_t rate)
+{
+	uint32_t parent = clock_get_rate(&self->clock);
+	uint32_t m = 0, n;
+
+	/* SCL = parent / 2^N / (M + 1) / 10. Find the smallest divider that
+	 * does not exceed the requested rate. */
+	for (n = 0; n < 8; ++n) {
+		m = ((parent >> n) + 10 * rate - 1) / (10 * rate);
+		if (m <= 16)
+			break;
+	}
+	if (m > 0)
+		m = m - 1;
+	if (m > 15)
+		m = 15;
+	if (n > 7)
+		n = 7;
+
+	mmio_write_32(self->regs + I2C_CCR_REG, m << 3 | n);
+}
+
 static int
-sun6i_i2c_read(const struct regmap *map, uint8_t *data)
+sun6i_i2c_read(const struct regmap *map, uint8_t *data, bool ack)
 {
 	const struct simple_device *self = to_simple_device(map->dev);
 	int err;
 
-	/* Disable sending an ACK and trigger a state change. */
-	mmio_clrset_32(self->regs + I2C_CTRL_REG, BIT(2), BIT(3));
+	/* Choose whether to send an ACK and trigger a state change. */
+	if (ack)
+		mmio_set_32(self->regs + I2C_CTRL_REG, BIT(3) | BIT(2));
+	else
+		mmio_clrset_32(self->regs + I2C_CTRL_REG, BIT(2), BIT(3));
 
 	/* Wait for data to arrive. */
-	if ((err = sun6i_i2c_wait_state(self, DATA_RX_NACK)))
+	if ((err = sun6i_i2c_wait_state(self, ack ? DATA_RX_ACK
+	                                          : DATA_RX_NACK)))
 		return err;
 
 	/* Read the data. */
@@ -124,10 +155,6 @@ sun6i_i2c_start(const struct regmap *map, uint8_t direction)
 	/* Send a start condition. */
 	mmio_set_32(self->regs + I2C_CTRL_REG, BIT(5) | BIT(3));
 
-	/* Wait for the start condition to be sent. */
-	if ((err = sun6i_i2c_wait_start(self)))
-		return err;
-
 	/* Wait for the start state if the bus was previously idle; otherwise,
 	 * wait for the repeated start state. */
 	state = init_state == IDLE ? START_COND_TX : START_COND_TX_REPEAT;
@@ -184,16 +211,16 @@ sun6i_i2c_probe(const struct device *dev)
 	if ((err = simple_device_probe(dev)))
 		return err;
 
-	/* Set I2C bus clock divider for 400 KHz operation. */
-	mmio_write_32(self->regs + I2C_CCR_REG, 0x00000011);
+	/* Use fast mode (400 kHz). */
+	sun6i_i2c_set_rate(self, I2C_RATE);
 
 	/* Clear slave address (this driver only supports master mode). */
 	mmio_write_32(self->regs + I2C_ADDR_REG, 0);
 	mmio_write_32(self->regs + I2C_XADDR_REG, 0);
 
-	/* Enable I2C bus and stop any current transaction. Disable interrupts
+	/* Enable I2C bus and stop any current transaction. Enable interrupts
 	 * and don't send an ACK for received bytes. */
-	mmio_write_32(self->regs + I2C_CTRL_REG, BIT(6) | BIT(4));
+	mmio_write_32(self->regs + I2C_CTRL_REG, BIT(7) | BIT(6) | BIT(4));
 
 	/* Soft reset the controller. */
 	mmio_set_32(self->regs + I2C_SRST_REG, BIT(0));
@@ -213,8 +240,9 @@ err_release:
 static const struct regmap_i2c_driver sun6i_i2c_driver = {
 	.drv = {
 		.drv = {
-			.probe   = sun6i_i2c_probe,
-			.release = simple_device_release,
+			.probe             = sun6i_i2c_probe,
+			.release           = simple_device_release,
+			.autosuspend_delay = REGMAP_AUTOSUSPEND_DELAY,
 		},
 		.ops = {
 			.prepare = regmap_i2c_prepare,
@@ -234,7 +262,7 @@ const struct simple_device r_i2c = {
 	.dev = {
 		.name  = "r_i2c",
 		.drv   = &sun6i_i2c_driver.drv.drv,
-		.state = DEVICE_STATE_INIT,
+		.state = DEVICE_AUTOSUSPEND_STATE_INIT,
 	},
 	.clock = { .dev = &r_ccu.dev, .id = CLK_BUS_R_I2C },
 #if CONFIG(I2C_PINS_PL0_PL1)
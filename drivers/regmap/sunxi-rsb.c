@@ -5,6 +5,7 @@
 
 #include <error.h>
 #include <mmio.h>
+#include <stdbool.h>
 #include <util.h>
 #include <clock/ccu.h>
 #include <gpio/sunxi-gpio.h>
@@ -27,6 +28,9 @@
 
 #define I2C_BCAST_ADDR 0
 
+/* Rate used while switching devices from I2C mode, and as a fallback. */
+#define DEFAULT_RATE   3000000
+
 #define PMIC_MODE_REG  0x3e
 #define PMIC_MODE_VAL  0x7c
 
@@ -40,6 +44,9 @@ enum {
 	RSB_WR32 = 0x63,
 };
 
+/* Set once the configured rate has failed verification. */
+static bool sunxi_rsb_use_default_rate;
+
 static int
 sunxi_rsb_do_command(const struct regmap *map, uint32_t cmd)
 {
@@ -62,31 +69,76 @@ sunxi_rsb_prepare(const struct regmap *map)
 	return sunxi_rsb_do_command(map, RSB_SRTA);
 }
 
+/**
+ * Choose the widest transfer that fits in the remaining byte count.
+ *
+ * A 16- or 32-bit command covers consecutive registers starting at RSB_ADDR,
+ * with the first register in the least significant byte of RSB_DATA. This is
+ * how Linux's sunxi-rsb bus driver packs 16- and 32-bit transfers.
+ */
+static uint8_t
+sunxi_rsb_width(uint8_t count)
+{
+	if (count >= 4)
+		return 4;
+	if (count >= 2)
+		return 2;
+	return 1;
+}
+
 static int
-sunxi_rsb_read(const struct regmap *map, uint8_t addr, uint8_t *data)
+sunxi_rsb_read(const struct regmap *map, uint8_t addr, uint8_t *data,
+               uint8_t count)
 {
+	static const uint8_t cmds[] = { 0, RSB_RD8, RSB_RD16, 0, RSB_RD32 };
 	const struct simple_device *self = to_simple_device(map->dev);
+	uint8_t width;
+	uint32_t val;
 	int err;
 
-	mmio_write_32(self->regs + RSB_ADDR_REG, addr);
+	for (; count; addr += width, data += width, count -= width) {
+		width = sunxi_rsb_width(count);
 
-	if ((err = sunxi_rsb_do_command(map, RSB_RD8)))
-		return err;
+		mmio_write_32(self->regs + RSB_ADDR_REG, addr);
+
+		if ((err = sunxi_rsb_do_command(map, cmds[width])))
+			return err;
 
-	*data = mmio_read_32(self->regs + RSB_DATA_REG);
+		/* The first register is in the least significant byte. */
+		val = mmio_read_32(self->regs + RSB_DATA_REG);
+		for (uint8_t i = 0; i < width; ++i)
+			data[i] = val >> (8 * i);
+	}
 
 	return SUCCESS;
 }
 
 static int
-sunxi_rsb_write(const struct regmap *map, uint8_t addr, uint8_t data)
+sunxi_rsb_write(const struct regmap *map, uint8_t addr, const uint8_t *data,
+                uint8_t count)
 {
+	static const uint8_t cmds[] = { 0, RSB_WR8, RSB_WR16, 0, RSB_WR32 };
 	const struct simple_device *self = to_simple_device(map->dev);
+	uint8_t width;
+	uint32_t val;
+	int err;
+
+	for (; count; addr += width, data += width, count -= width) {
+		width = sunxi_rsb_width(count);
 
-	mmio_write_32(self->regs + RSB_ADDR_REG, addr);
-	mmio_write_32(self->regs + RSB_DATA_REG, data);
+		/* The first register is in the least significant byte. */
+		val = 0;
+		for (uint8_t i = 0; i < width; ++i)
+			val |= (uint32_t)data[i] << (8 * i);
 
-	return sunxi_rsb_do_command(map, RSB_WR8);
+		mmio_write_32(self->regs + RSB_ADDR_REG, addr);
+		mmio_write_32(self->regs + RSB_DATA_REG, val);
+
+		if ((err = sunxi_rsb_do_command(map, cmds[width])))
+			return err;
+	}
+
+	return SUCCESS;
 }
 
 static void
@@ -116,20 +168,36 @@ sunxi_rsb_probe(const struct device *dev)
 	mmio_pollz_32(self->regs + RSB_CTRL_REG, BIT(0));
 
 	/* Set the bus clock rate to its default value (3 MHz). */
-	sunxi_rsb_set_rate(self, 3000000);
+	sunxi_rsb_set_rate(self, DEFAULT_RATE);
 
 	/* Switch all devices to RSB mode. */
 	mmio_write_32(self->regs + RSB_PMCR_REG, I2C_BCAST_ADDR |
 	              PMIC_MODE_REG << 8 | PMIC_MODE_VAL << 16 | BIT(31));
 	mmio_pollz_32(self->regs + RSB_PMCR_REG, BIT(31));
 
+	/* Switch to the configured rate, unless it was found unreliable. */
+	if (!sunxi_rsb_use_default_rate && CONFIG_RSB_RATE != DEFAULT_RATE)
+		sunxi_rsb_set_rate(self, CONFIG_RSB_RATE);
+
+	return SUCCESS;
+}
+
+int
+sunxi_rsb_reduce_rate(void)
+{
+	if (sunxi_rsb_use_default_rate || CONFIG_RSB_RATE <= DEFAULT_RATE)
+		return ENOTSUP;
+
+	sunxi_rsb_use_default_rate = true;
+
 	return SUCCESS;
 }
 
 static const struct regmap_driver sunxi_rsb_driver = {
 	.drv = {
-		.probe   = sunxi_rsb_probe,
-		.release = simple_device_release,
+		.probe             = sunxi_rsb_probe,
+		.release           = simple_device_release,
+		.autosuspend_delay = REGMAP_AUTOSUSPEND_DELAY,
 	},
 	.ops = {
 		.prepare = sunxi_rsb_prepare,
@@ -142,7 +210,7 @@ const struct simple_device r_rsb = {
 	.dev = {
 		.name  = "r_rsb",
 		.drv   = &sunxi_rsb_driver.drv,
-		.state = DEVICE_STATE_INIT,
+		.state = DEVICE_AUTOSUSPEND_STATE_INIT,
 	},
 	.clock = { .dev = &r_ccu.dev, .id = CLK_BUS_R_RSB },
 	.pins  = SIMPLE_DEVICE_PINS_INIT {
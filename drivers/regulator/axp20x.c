@@ -5,6 +5,7 @@
 
 #include <error.h>
 #include <regmap.h>
+#include <regulator.h>
 
 #include "axp20x.h"
 
@@ -12,6 +13,9 @@
 #define GPIO_LDO_ON   0x3
 #define GPIO_LDO_OFF  0x4
 
+/* Switches have no soft start; they follow their input. */
+#define SWITCH_TIME   100 /* us */
+
 static int
 axp20x_regulator_get_state(const struct regulator_handle *handle,
                            bool *enabled)
@@ -38,7 +42,61 @@ axp20x_regulator_get_state(const struct regulator_handle *handle,
 }
 
 static int
-axp20x_regulator_set_state(const struct regulator_handle *handle, bool enabled)
+axp20x_regulator_get_voltage(const struct regulator_handle *handle,
+                             uint32_t *voltage)
+{
+	const struct axp20x_regulator *self = to_axp20x_regulator(handle->dev);
+	const struct axp20x_regulator_info *info = &self->info[handle->id];
+	uint8_t first = 0;
+	uint8_t sel;
+	int err;
+
+	if (!info->ranges[0].step)
+		return ENOTSUP;
+	if ((err = regmap_read(self->map, info->value_register, &sel)))
+		return err;
+	sel &= info->value_mask;
+
+	for (int i = 0; i < AXP20X_REGULATOR_MAX_RANGES; ++i) {
+		const struct axp20x_regulator_range *range = &info->ranges[i];
+
+		if (!range->step)
+			break;
+		if (sel <= range->max_sel) {
+			*voltage = range->min_value +
+			           (sel - first) * range->step;
+			return SUCCESS;
+		}
+		first = range->max_sel + 1;
+	}
+
+	/* The selector is reserved. */
+	return EIO;
+}
+
+static int
+axp20x_regulator_get_ramp_time(const struct regulator_handle *handle,
+                               uint32_t *time)
+{
+	uint32_t voltage;
+	int err;
+
+	err = axp20x_regulator_get_voltage(handle, &voltage);
+	if (err == ENOTSUP) {
+		*time = SWITCH_TIME;
+		return SUCCESS;
+	}
+	if (err)
+		return err;
+
+	*time = regulator_voltage_ramp_time(voltage);
+
+	return SUCCESS;
+}
+
+static struct regmap_seq_step
+axp20x_regulator_state_step(const struct regulator_handle *handle,
+                            bool enabled)
 {
 	const struct axp20x_regulator *self = to_axp20x_regulator(handle->dev);
 	uint8_t addr = self->info[handle->id].enable_register;
@@ -54,7 +112,40 @@ axp20x_regulator_set_state(const struct regulator_handle *handle, bool enabled)
 	else
 		val = enabled ? mask : 0;
 
-	return regmap_update_bits(self->map, addr, mask, val);
+	return (struct regmap_seq_step) { addr, mask, val };
+}
+
+static int
+axp20x_regulator_set_state(const struct regulator_handle *handle, bool enabled)
+{
+	const struct axp20x_regulator *self = to_axp20x_regulator(handle->dev);
+	struct regmap_seq_step step;
+
+	step = axp20x_regulator_state_step(handle, enabled);
+
+	return regmap_update_bits(self->map, step.reg, step.mask, step.val);
+}
+
+static int
+axp20x_regulator_set_states(const struct regulator_handle *const *handles,
+                            uint8_t count, bool enabled)
+{
+	const struct axp20x_regulator *self =
+		to_axp20x_regulator(handles[0]->dev);
+	struct regmap_seq_step seq[REGULATOR_LIST_MAX];
+
+	/* Sort the steps by register, so each register is written once. */
+	for (uint8_t i = 0; i < count; ++i) {
+		struct regmap_seq_step step;
+		uint8_t j;
+
+		step = axp20x_regulator_state_step(handles[i], enabled);
+		for (j = i; j > 0 && seq[j - 1].reg > step.reg; --j)
+			seq[j] = seq[j - 1];
+		seq[j] = step;
+	}
+
+	return regmap_run_sequence(self->map, seq, count);
 }
 
 static int
@@ -79,7 +170,10 @@ const struct regulator_driver axp20x_regulator_driver = {
 		.release = axp20x_regulator_release,
 	},
 	.ops = {
-		.get_state = axp20x_regulator_get_state,
-		.set_state = axp20x_regulator_set_state,
+		.get_ramp_time = axp20x_regulator_get_ramp_time,
+		.get_state     = axp20x_regulator_get_state,
+		.get_voltage   = axp20x_regulator_get_voltage,
+		.set_state     = axp20x_regulator_set_state,
+		.set_states    = axp20x_regulator_set_states,
 	},
 };
@@ -12,11 +12,24 @@
 
 #include "regulator.h"
 
+#define AXP20X_REGULATOR_MAX_RANGES 2
+
+/**
+ * A linear range of output voltages. Each range starts at the selector
+ * following the end of the previous range.
+ */
+struct axp20x_regulator_range {
+	uint16_t min_value; /**< Voltage at the first selector, in mV. */
+	uint8_t  step;      /**< Voltage increment per selector, in mV. */
+	uint8_t  max_sel;   /**< Last selector in this range. */
+};
+
 struct axp20x_regulator_info {
-	uint8_t enable_register;
-	uint8_t enable_mask;
-	uint8_t value_register;
-	uint8_t value_mask;
+	uint8_t                       enable_register;
+	uint8_t                       enable_mask;
+	uint8_t                       value_register;
+	uint8_t                       value_mask;
+	struct axp20x_regulator_range ranges[AXP20X_REGULATOR_MAX_RANGES];
 };
 
 extern const struct regulator_driver axp20x_regulator_driver;
@@ -19,90 +19,139 @@ static const struct axp20x_regulator_info axp805_regulators[] = {
 		.enable_mask     = BIT(0),
 		.value_register  = 0x12,
 		.value_mask      = GENMASK(6, 0),
+		.ranges          = {
+			{  600,  10, 0x32 },
+			{ 1120,  20, 0x47 },
+		},
 	},
 	[AXP805_REGL_DCDCB] = {
 		.enable_register = POWER_ONOFF_CTRL_REG1,
 		.enable_mask     = BIT(1),
 		.value_register  = 0x13,
 		.value_mask      = GENMASK(4, 0),
+		.ranges          = {
+			{ 1000,  50, 0x1f },
+		},
 	},
 	[AXP805_REGL_DCDCC] = {
 		.enable_register = POWER_ONOFF_CTRL_REG1,
 		.enable_mask     = BIT(2),
 		.value_register  = 0x14,
 		.value_mask      = GENMASK(6, 0),
+		.ranges          = {
+			{  600,  10, 0x32 },
+			{ 1120,  20, 0x47 },
+		},
 	},
 	[AXP805_REGL_DCDCD] = {
 		.enable_register = POWER_ONOFF_CTRL_REG1,
 		.enable_mask     = BIT(3),
 		.value_register  = 0x15,
 		.value_mask      = GENMASK(5, 0),
+		.ranges          = {
+			{  600,  20, 0x2d },
+			{ 1600, 100, 0x3f },
+		},
 	},
 	[AXP805_REGL_DCDCE] = {
 		.enable_register = POWER_ONOFF_CTRL_REG1,
 		.enable_mask     = BIT(4),
 		.value_register  = 0x16,
 		.value_mask      = GENMASK(4, 0),
+		.ranges          = {
+			{ 1100, 100, 0x17 },
+		},
 	},
 	[AXP805_REGL_ALDO1] = {
 		.enable_register = POWER_ONOFF_CTRL_REG1,
 		.enable_mask     = BIT(5),
 		.value_register  = 0x17,
 		.value_mask      = GENMASK(4, 0),
+		.ranges          = {
+			{  700, 100, 0x1a },
+		},
 	},
 	[AXP805_REGL_ALDO2] = {
 		.enable_register = POWER_ONOFF_CTRL_REG1,
 		.enable_mask     = BIT(6),
 		.value_register  = 0x18,
 		.value_mask      = GENMASK(4, 0),
+		.ranges          = {
+			{  700, 100, 0x1a },
+		},
 	},
 	[AXP805_REGL_ALDO3] = {
 		.enable_register = POWER_ONOFF_CTRL_REG1,
 		.enable_mask     = BIT(7),
 		.value_register  = 0x19,
 		.value_mask      = GENMASK(4, 0),
+		.ranges          = {
+			{  700, 100, 0x1a },
+		},
 	},
 	[AXP805_REGL_BLDO1] = {
 		.enable_register = POWER_ONOFF_CTRL_REG2,
 		.enable_mask     = BIT(0),
 		.value_register  = 0x20,
 		.value_mask      = GENMASK(3, 0),
+		.ranges          = {
+			{  700, 100, 0x0c },
+		},
 	},
 	[AXP805_REGL_BLDO2] = {
 		.enable_register = POWER_ONOFF_CTRL_REG2,
 		.enable_mask     = BIT(1),
 		.value_register  = 0x21,
 		.value_mask      = GENMASK(3, 0),
+		.ranges          = {
+			{  700, 100, 0x0c },
+		},
 	},
 	[AXP805_REGL_BLDO3] = {
 		.enable_register = POWER_ONOFF_CTRL_REG2,
 		.enable_mask     = BIT(2),
 		.value_register  = 0x22,
 		.value_mask      = GENMASK(3, 0),
+		.ranges          = {
+			{  700, 100, 0x0c },
+		},
 	},
 	[AXP805_REGL_BLDO4] = {
 		.enable_register = POWER_ONOFF_CTRL_REG2,
 		.enable_mask     = BIT(3),
 		.value_register  = 0x23,
 		.value_mask      = GENMASK(3, 0),
+		.ranges          = {
+			{  700, 100, 0x0c },
+		},
 	},
 	[AXP805_REGL_CLDO1] = {
 		.enable_register = POWER_ONOFF_CTRL_REG2,
 		.enable_mask     = BIT(4),
 		.value_register  = 0x24,
 		.value_mask      = GENMASK(4, 0),
+		.ranges          = {
+			{  700, 100, 0x1a },
+		},
 	},
 	[AXP805_REGL_CLDO2] = {
 		.enable_register = POWER_ONOFF_CTRL_REG2,
 		.enable_mask     = BIT(5),
 		.value_register  = 0x25,
 		.value_mask      = GENMASK(4, 0),
+		.ranges          = {
+			{  700, 100, 0x1a },
+			{ 3400, 200, 0x1f },
+		},
 	},
 	[AXP805_REGL_CLDO3] = {
 		.enable_register = POWER_ONOFF_CTRL_REG2,
 		.enable_mask     = BIT(6),
 		.value_register  = 0x26,
 		.value_mask      = GENMASK(4, 0),
+		.ranges          = {
+			{  700, 100, 0x1a },
+		},
 	},
 	[AXP805_REGL_DCSW] = {
 		.enable_register = POWER_ONOFF_CTRL_REG2,
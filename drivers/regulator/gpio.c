@@ -3,6 +3,7 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <error.h>
 #include <gpio/sunxi-gpio.h>
 #include <regulator/gpio.h>
 
@@ -14,6 +15,15 @@ to_gpio_regulator(const struct device *dev)
 	return container_of(dev, const struct gpio_regulator, dev);
 }
 
+static int
+gpio_regulator_get_ramp_time(const struct regulator_handle *handle UNUSED,
+                             uint32_t *time)
+{
+	*time = CONFIG_REGULATOR_GPIO_RAMP_TIME;
+
+	return SUCCESS;
+}
+
 static int
 gpio_regulator_get_state(const struct regulator_handle *handle, bool *enabled)
 {
@@ -52,8 +62,9 @@ static const struct regulator_driver gpio_regulator_driver = {
 		.release = gpio_regulator_release,
 	},
 	.ops = {
-		.get_state = gpio_regulator_get_state,
-		.set_state = gpio_regulator_set_state,
+		.get_ramp_time = gpio_regulator_get_ramp_time,
+		.get_state     = gpio_regulator_get_state,
+		.set_state     = gpio_regulator_set_state,
 	},
 };
 
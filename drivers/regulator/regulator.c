@@ -3,15 +3,25 @@
  * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
  */
 
+#include <debug.h>
 #include <device.h>
 #include <error.h>
 #include <intrusive.h>
 #include <regulator.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <timeout.h>
+#include <util.h>
 
 #include "regulator.h"
 
+/* Used when the actual rise time is unknown. */
+#define DEFAULT_RAMP_TIME 25000 /* 25ms */
+
+/* The soft-start slew rate, with some margin, and the settling time. */
+#define RAMP_RATE         500   /* mV/ms */
+#define SETTLE_TIME       200   /* us */
+
 /**
  * Get the ops for the regulator controller device.
  */
@@ -45,12 +55,80 @@ regulator_disable(const struct regulator_handle *handle)
 	return regulator_set_state(handle, false);
 }
 
+int
+regulator_disable_list(const struct regulator_handle *const *handles,
+                       uint8_t count)
+{
+	const struct regulator_handle *group[REGULATOR_LIST_MAX];
+	uint8_t done = 0;
+	int ret = SUCCESS;
+
+	assert(count <= REGULATOR_LIST_MAX);
+
+	for (uint8_t i = 0; i < count; ++i) {
+		const struct device *dev = handles[i]->dev;
+		const struct regulator_driver_ops *ops;
+		uint8_t n = 0;
+		int err;
+
+		if (done & BIT(i))
+			continue;
+
+		/* Collect the remaining regulators with the same supplier. */
+		for (uint8_t j = i; j < count; ++j) {
+			if (handles[j]->dev == dev) {
+				group[n++] = handles[j];
+				done |= BIT(j);
+			}
+		}
+
+		if (!(err = device_get(dev))) {
+			ops = regulator_ops_for(dev);
+			if (ops->set_states) {
+				err = ops->set_states(group, n, false);
+			} else {
+				for (uint8_t j = 0; j < n && !err; ++j)
+					err = ops->set_state(group[j], false);
+			}
+			device_put(dev);
+		}
+		if (err && !ret)
+			ret = err;
+	}
+
+	return ret;
+}
+
 int
 regulator_enable(const struct regulator_handle *handle)
 {
 	return regulator_set_state(handle, true);
 }
 
+uint32_t
+regulator_get_ramp_time(const struct regulator_handle *handle)
+{
+	const struct regulator_driver_ops *ops;
+	uint32_t time = DEFAULT_RAMP_TIME;
+
+	if (!handle->dev || device_get(handle->dev))
+		return handle->dev ? DEFAULT_RAMP_TIME : 0;
+
+	ops = regulator_ops_for(handle->dev);
+	if (ops->get_ramp_time && ops->get_ramp_time(handle, &time))
+		time = DEFAULT_RAMP_TIME;
+
+	device_put(handle->dev);
+
+	return time;
+}
+
+uint32_t
+regulator_voltage_ramp_time(uint32_t voltage)
+{
+	return voltage * USEC_PER_MSEC / RAMP_RATE + SETTLE_TIME;
+}
+
 int
 regulator_get_state(const struct regulator_handle *handle, bool *enabled)
 {
@@ -65,3 +143,21 @@ regulator_get_state(const struct regulator_handle *handle, bool *enabled)
 
 	return err;
 }
+
+int
+regulator_get_voltage(const struct regulator_handle *handle,
+                      uint32_t *voltage)
+{
+	const struct regulator_driver_ops *ops;
+	int err;
+
+	if ((err = device_get(handle->dev)))
+		return err;
+
+	ops = regulator_ops_for(handle->dev);
+	err = ops->get_voltage ? ops->get_voltage(handle, voltage) : ENOTSUP;
+
+	device_put(handle->dev);
+
+	return err;
+}
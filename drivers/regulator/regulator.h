@@ -11,8 +11,14 @@
 #include <stdint.h>
 
 struct regulator_driver_ops {
+	int (*get_ramp_time)(const struct regulator_handle *handle,
+	                     uint32_t *time);
 	int (*get_state)(const struct regulator_handle *handle, bool *enabled);
 	int (*set_state)(const struct regulator_handle *handle, bool enable);
+	int (*set_states)(const struct regulator_handle *const *handles,
+	                  uint8_t count, bool enable);
+	int (*get_voltage)(const struct regulator_handle *handle,
+	                   uint32_t *voltage);
 };
 
 struct regulator_driver {
@@ -20,4 +26,14 @@ struct regulator_driver {
 	struct regulator_driver_ops ops;
 };
 
+/**
+ * Calculate the time for a soft-started output to rise from zero to a given
+ * voltage and settle, at a slew rate that is conservative for all supported
+ * regulators.
+ *
+ * @param voltage The output voltage in millivolts.
+ * @return        The rise time in microseconds.
+ */
+uint32_t regulator_voltage_ramp_time(uint32_t voltage);
+
 #endif /* REGULATOR_PRIVATE_H */
@@ -16,6 +16,16 @@
 #define VOUT_COM_REG   0x02
 #define SYS_STATUS_REG 0x06
 
+#define VOUT_SEL_MASK  GENMASK(6, 0)
+#define VOUT_MIN_VALUE 680
+#define VOUT_STEP      10
+
+static const struct regmap_range sy8106a_volatile_ranges[] = {
+	{ SYS_STATUS_REG, SYS_STATUS_REG },
+};
+
+DEFINE_REGMAP_CACHE(sy8106a_cache, SYS_STATUS_REG, sy8106a_volatile_ranges);
+
 static int
 sy8106a_get_state(const struct regulator_handle *handle, bool *enabled)
 {
@@ -31,6 +41,35 @@ sy8106a_get_state(const struct regulator_handle *handle, bool *enabled)
 	return SUCCESS;
 }
 
+static int
+sy8106a_get_voltage(const struct regulator_handle *handle, uint32_t *voltage)
+{
+	const struct regmap_device *self = to_regmap_device(handle->dev);
+	uint8_t val;
+	int err;
+
+	if ((err = regmap_read(&self->map, VOUT_SEL_REG, &val)))
+		return err;
+
+	*voltage = VOUT_MIN_VALUE + (val & VOUT_SEL_MASK) * VOUT_STEP;
+
+	return SUCCESS;
+}
+
+static int
+sy8106a_get_ramp_time(const struct regulator_handle *handle, uint32_t *time)
+{
+	uint32_t voltage;
+	int err;
+
+	if ((err = sy8106a_get_voltage(handle, &voltage)))
+		return err;
+
+	*time = regulator_voltage_ramp_time(voltage);
+
+	return SUCCESS;
+}
+
 static int
 sy8106a_set_state(const struct regulator_handle *handle, bool enabled)
 {
@@ -50,8 +89,10 @@ static const struct regulator_driver sy8106a_driver = {
 		.release = regmap_device_release,
 	},
 	.ops = {
-		.get_state = sy8106a_get_state,
-		.set_state = sy8106a_set_state,
+		.get_ramp_time = sy8106a_get_ramp_time,
+		.get_state     = sy8106a_get_state,
+		.get_voltage   = sy8106a_get_voltage,
+		.set_state     = sy8106a_set_state,
 	},
 };
 
@@ -62,7 +103,8 @@ const struct regmap_device sy8106a = {
 		.state = DEVICE_STATE_INIT,
 	},
 	.map = {
-		.dev = &r_i2c.dev,
-		.id  = SY8106A_I2C_ADDRESS,
+		.dev   = &r_i2c.dev,
+		.cache = REGMAP_CACHE(sy8106a_cache),
+		.id    = SY8106A_I2C_ADDRESS,
 	},
 };
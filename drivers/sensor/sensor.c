@@ -0,0 +1,43 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <debug.h>
+#include <device.h>
+#include <intrusive.h>
+#include <sensor.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "sensor.h"
+
+/**
+ * Get the ops for the sensor provider device.
+ */
+static inline const struct sensor_driver_ops *
+sensor_ops_for(const struct device *dev)
+{
+	const struct sensor_driver *drv =
+		container_of(dev->drv, const struct sensor_driver, drv);
+
+	return &drv->ops;
+}
+
+bool
+sensor_calibrated(const struct sensor_handle *handle)
+{
+	const struct sensor_driver_ops *ops = sensor_ops_for(handle->dev);
+
+	assert(device_active(handle->dev));
+
+	return !ops->calibrated || ops->calibrated(handle);
+}
+
+int
+sensor_read(const struct sensor_handle *handle, uint32_t *value)
+{
+	assert(device_active(handle->dev));
+
+	return sensor_ops_for(handle->dev)->read(handle, value);
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef SENSOR_PRIVATE_H
+#define SENSOR_PRIVATE_H
+
+#include <device.h>
+#include <sensor.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+struct sensor_driver_ops {
+	bool (*calibrated)(const struct sensor_handle *handle);
+	int  (*read)(const struct sensor_handle *handle, uint32_t *value);
+};
+
+struct sensor_driver {
+	struct driver            drv;
+	struct sensor_driver_ops ops;
+};
+
+#endif /* SENSOR_PRIVATE_H */
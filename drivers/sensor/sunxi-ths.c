@@ -0,0 +1,258 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <clock.h>
+#include <error.h>
+#include <intrusive.h>
+#include <mmio.h>
+#include <stdbool.h>
+#include <util.h>
+#include <clock/ccu.h>
+#include <sensor/sunxi-ths.h>
+#include <platform/devices.h>
+
+#include "sensor.h"
+
+#if CONFIG(PLATFORM_H6)
+
+#define THS_CTRL_REG     0x00
+#define THS_ENABLE_REG   0x04
+#define THS_PERIOD_REG   0x08
+#define THS_FILTER_REG   0x30
+#define THS_DATA_REG(n)  (0xc0 + 4 * (n))
+
+#define THS_SENSORS      2
+
+/*
+ * Average over 4 samples, and take a sample every 0.25s:
+ * (365 + 1) * 4096 * 4 / 24MHz.
+ */
+#define THS_PERIOD       365
+
+#else
+
+#define THS_CTRL_REG     0x00
+#define THS_ENABLE_REG   0x40
+#define THS_PERIOD_REG   0x44
+#define THS_FILTER_REG   0x70
+#define THS_CALIB_REG(n) (0x74 + 4 * ((n) / 2))
+#define THS_DATA_REG(n)  (0x80 + 4 * (n))
+
+#if CONFIG(PLATFORM_H3)
+#define THS_SENSORS      1
+#elif CONFIG(SOC_H5)
+#define THS_SENSORS      2
+#else
+#define THS_SENSORS      3
+#endif
+
+/*
+ * Average over 4 samples, and take a sample every 40ms:
+ * (58 + 1) * 4096 * 4 / 24MHz.
+ */
+#define THS_PERIOD       58
+
+#define SID_PRCTL_REG    0x40
+#define SID_RDKEY_REG    0x60
+#define SID_PRCTL_OFFSET(x) ((x) << 16)
+#define SID_PRCTL_LOCK   (0xac << 8)
+#define SID_PRCTL_READ   BIT(1)
+
+/* Offset of the THS calibration data in the eFuse array. */
+#define SID_THS_CALIB    0x34
+
+#endif
+
+/* Take each sample over 20us: (479 + 1) / 24MHz. */
+#define THS_ACQ_TIME     479
+
+#define THS_FILTER_EN    BIT(2)
+#define THS_FILTER_4     1
+
+#define THS_DATA_MASK    GENMASK(11, 0)
+
+/* Whether factory calibration values were programmed into the THS. */
+static bool sunxi_ths_is_calibrated;
+
+static inline const struct sunxi_ths *
+to_sunxi_ths(const struct device *dev)
+{
+	return container_of(dev, const struct sunxi_ths, dev);
+}
+
+/*
+ * Convert a raw sample to millidegrees Celsius, using the linear
+ * approximations from the vendor documentation.
+ */
+static int32_t
+sunxi_ths_calc_temp(uint32_t id UNUSED, uint32_t raw)
+{
+#if CONFIG(PLATFORM_H6)
+	return 187744 - (int32_t)(raw * 672 / 10);
+#elif CONFIG(PLATFORM_H3)
+	return 217000 - (int32_t)(raw * 1211 / 10);
+#elif CONFIG(SOC_H5)
+	if (raw >= 0x500)
+		return 223000 - (int32_t)(raw * 1191 / 10);
+	if (id == 0)
+		return 259000 - (int32_t)(raw * 1452 / 10);
+	return 276000 - (int32_t)(raw * 1590 / 10);
+#else
+	return 260890 - (int32_t)(raw * 1170 / 10);
+#endif
+}
+
+#if !CONFIG(PLATFORM_H6)
+/*
+ * Read a word from the eFuse array through the SID registers. Direct reads
+ * of the eFuse SRAM copy may return stale values on some SoCs.
+ */
+static uint32_t
+sunxi_ths_read_sid(uint32_t offset)
+{
+	uint32_t val;
+
+	mmio_write_32(DEV_SID + SID_PRCTL_REG, SID_PRCTL_OFFSET(offset) |
+	              SID_PRCTL_LOCK | SID_PRCTL_READ);
+	mmio_pollz_32(DEV_SID + SID_PRCTL_REG, SID_PRCTL_READ);
+	val = mmio_read_32(DEV_SID + SID_RDKEY_REG);
+	mmio_write_32(DEV_SID + SID_PRCTL_REG, 0);
+
+	return val;
+}
+
+/*
+ * Program the per-sensor calibration values measured at the factory. Each
+ * 16-bit eFuse half-word maps directly to a 12-bit calibration field.
+ */
+static void
+sunxi_ths_calibrate(const struct sunxi_ths *self)
+{
+	for (uint32_t i = 0; i < THS_SENSORS; i += 2) {
+		uint32_t calib = sunxi_ths_read_sid(SID_THS_CALIB + 2 * i);
+		uint32_t mask  = i + 1 < THS_SENSORS ? 0x0fff0fff : 0x0fff;
+
+		/* Unprogrammed eFuses mean the chip was not calibrated. */
+		if (i == 0 && !(calib & 0xffff))
+			return;
+
+		mmio_clrset_32(self->regs + THS_CALIB_REG(i), mask,
+		               calib & mask);
+	}
+
+	sunxi_ths_is_calibrated = true;
+}
+#endif
+
+/*
+ * The H6 calibration format is not supported, so its readings may be off by
+ * several degrees.
+ */
+static bool
+sunxi_ths_calibrated(const struct sensor_handle *handle UNUSED)
+{
+	return sunxi_ths_is_calibrated;
+}
+
+static int
+sunxi_ths_read(const struct sensor_handle *handle, uint32_t *value)
+{
+	const struct sunxi_ths *self = to_sunxi_ths(handle->dev);
+	uint32_t raw;
+	int32_t temp;
+
+	/* The data register reads as zero until the first sample is ready. */
+	raw = mmio_read_32(self->regs + THS_DATA_REG(handle->id));
+	raw &= THS_DATA_MASK;
+	if (!raw)
+		return EBUSY;
+
+	/* Sensor values are unsigned, so report 0°C for any lower value. */
+	temp   = sunxi_ths_calc_temp(handle->id, raw);
+	*value = temp > 0 ? (uint32_t)temp : 0;
+
+	return SUCCESS;
+}
+
+static int
+sunxi_ths_probe(const struct device *dev)
+{
+	const struct sunxi_ths *self = to_sunxi_ths(dev);
+	uintptr_t regs = self->regs;
+	int err;
+
+	/*
+	 * Linux owns the THS reset, so keep the bus clock reference once it
+	 * is acquired. Releasing it would assert the reset.
+	 */
+	if (clock_active(&self->bus_clock))
+		clock_enable(&self->bus_clock);
+	else if ((err = clock_get(&self->bus_clock)))
+		return err;
+	if ((err = clock_get(&self->mod_clock)))
+		goto err_gate_bus_clock;
+
+#if CONFIG(PLATFORM_H6)
+	mmio_write_32(regs + THS_CTRL_REG, THS_ACQ_TIME << 16);
+	mmio_write_32(regs + THS_FILTER_REG, THS_FILTER_EN | THS_FILTER_4);
+	mmio_write_32(regs + THS_PERIOD_REG, THS_PERIOD << 12);
+	mmio_write_32(regs + THS_ENABLE_REG, GENMASK(THS_SENSORS - 1, 0));
+#else
+	sunxi_ths_calibrate(self);
+
+	mmio_write_32(regs + THS_FILTER_REG, THS_FILTER_EN | THS_FILTER_4);
+	mmio_write_32(regs + THS_CTRL_REG, THS_ACQ_TIME);
+	mmio_write_32(regs + THS_PERIOD_REG, THS_PERIOD << 12);
+	mmio_write_32(regs + THS_ENABLE_REG, THS_ACQ_TIME << 16 |
+	              GENMASK(THS_SENSORS - 1, 0));
+#endif
+
+	return SUCCESS;
+
+err_gate_bus_clock:
+	clock_disable(&self->bus_clock);
+
+	return err;
+}
+
+static void
+sunxi_ths_release(const struct device *dev)
+{
+	const struct sunxi_ths *self = to_sunxi_ths(dev);
+
+	/* Stop sampling before gating the clocks. */
+	mmio_write_32(self->regs + THS_ENABLE_REG, 0);
+
+	clock_put(&self->mod_clock);
+	/* Gate the bus clock without asserting the reset. */
+	clock_disable(&self->bus_clock);
+}
+
+static const struct sensor_driver sunxi_ths_driver = {
+	.drv = {
+		.probe   = sunxi_ths_probe,
+		.release = sunxi_ths_release,
+	},
+	.ops = {
+		.calibrated = sunxi_ths_calibrated,
+		.read       = sunxi_ths_read,
+	},
+};
+
+const struct sunxi_ths ths = {
+	.dev = {
+		.name  = "ths",
+		.drv   = &sunxi_ths_driver.drv,
+		.state = DEVICE_STATE_INIT,
+	},
+	.bus_clock = { .dev = &ccu.dev, .id = CLK_BUS_THS },
+#if CONFIG(PLATFORM_H6)
+	/* The H6 THS runs directly from OSC24M. */
+	.mod_clock = { .dev = &r_ccu.dev, .id = CLK_OSC24M },
+#else
+	.mod_clock = { .dev = &ccu.dev, .id = CLK_THS },
+#endif
+	.regs      = DEV_THS,
+};
@@ -0,0 +1,121 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#include <error.h>
+#include <mmio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <util.h>
+#include <clock/ccu.h>
+#include <timer/sunxi-timer.h>
+#include <platform/devices.h>
+
+#define TMR_IRQ_EN_REG    0x00
+#define TMR_IRQ_STA_REG   0x04
+#define TMR_CTRL_REG      0x10
+#define TMR_INTV_REG      0x14
+#define TMR_CUR_REG       0x18
+
+#define TMR_CTRL_EN       BIT(0)
+#define TMR_CTRL_RELOAD   BIT(1)
+#define TMR_CTRL_SRC_LOSC (0 << 2)
+#define TMR_CTRL_SINGLE   BIT(7)
+
+/* Only the first of the timers in the block is used. */
+#define TMR_IRQ           BIT(0)
+
+/* 32768 Hz / 1000000 us = 512 / 15625. */
+#define LOSC_NUM          512
+#define LOSC_DEN          15625
+
+bool
+sunxi_timer_poll(const struct device *dev)
+{
+	const struct simple_device *self = to_simple_device(dev);
+
+	return mmio_read_32(self->regs + TMR_IRQ_STA_REG) & TMR_IRQ;
+}
+
+uint32_t
+sunxi_timer_remaining(const struct device *dev)
+{
+	const struct simple_device *self = to_simple_device(dev);
+	uint32_t ticks;
+
+	if (sunxi_timer_poll(dev))
+		return 0;
+
+	/* Intervals are limited to 32-bit microseconds, so this fits. */
+	ticks = mmio_read_32(self->regs + TMR_CUR_REG);
+
+	return ticks / LOSC_NUM * LOSC_DEN +
+	       ticks % LOSC_NUM * LOSC_DEN / LOSC_NUM;
+}
+
+void
+sunxi_timer_start(const struct device *dev, uint32_t useconds)
+{
+	const struct simple_device *self = to_simple_device(dev);
+	uintptr_t regs = self->regs;
+	uint32_t ticks;
+
+	/* Avoid overflowing 32 bits during the conversion. */
+	ticks = useconds / LOSC_DEN * LOSC_NUM +
+	        useconds % LOSC_DEN * LOSC_NUM / LOSC_DEN;
+
+	/* Stop the timer and clear any previous expiration. */
+	mmio_write_32(regs + TMR_CTRL_REG, 0);
+	mmio_write_32(regs + TMR_IRQ_STA_REG, TMR_IRQ);
+
+	/* Load the new interval, then start counting down. */
+	mmio_write_32(regs + TMR_INTV_REG, ticks ? ticks : 1);
+	mmio_write_32(regs + TMR_CTRL_REG, TMR_CTRL_SINGLE |
+	              TMR_CTRL_SRC_LOSC | TMR_CTRL_RELOAD);
+	mmio_pollz_32(regs + TMR_CTRL_REG, TMR_CTRL_RELOAD);
+	mmio_set_32(regs + TMR_CTRL_REG, TMR_CTRL_EN);
+}
+
+static int
+sunxi_timer_probe(const struct device *dev)
+{
+	const struct simple_device *self = to_simple_device(dev);
+	int err;
+
+	if ((err = simple_device_probe(dev)))
+		return err;
+
+	/* Expiration is detected by polling the IRQ status bit. */
+	mmio_write_32(self->regs + TMR_IRQ_STA_REG, TMR_IRQ);
+	mmio_write_32(self->regs + TMR_IRQ_EN_REG, TMR_IRQ);
+
+	return SUCCESS;
+}
+
+static void
+sunxi_timer_release(const struct device *dev)
+{
+	const struct simple_device *self = to_simple_device(dev);
+
+	mmio_write_32(self->regs + TMR_CTRL_REG, 0);
+	mmio_write_32(self->regs + TMR_IRQ_EN_REG, 0);
+	mmio_write_32(self->regs + TMR_IRQ_STA_REG, TMR_IRQ);
+
+	simple_device_release(dev);
+}
+
+static const struct driver sunxi_timer_driver = {
+	.probe   = sunxi_timer_probe,
+	.release = sunxi_timer_release,
+};
+
+const struct simple_device r_timer = {
+	.dev = {
+		.name  = "r_timer",
+		.drv   = &sunxi_timer_driver,
+		.state = DEVICE_STATE_INIT,
+	},
+	.clock = { .dev = &r_ccu.dev, .id = CLK_BUS_R_TIMER },
+	.regs  = DEV_R_TIMER,
+};
@@ -6,6 +6,8 @@
 #include <debug.h>
 #include <error.h>
 #include <mmio.h>
+#include <timeout.h>
+#include <timer.h>
 #include <util.h>
 #include <clock/ccu.h>
 #include <watchdog/sunxi-twd.h>
@@ -24,6 +26,10 @@
 
 #define TWD_TIMEOUT     (30 * REFCLK_HZ) /* 5 seconds */
 
+#define TWD_INTERVAL    (1 * USEC_PER_SEC) /* 1 second */
+
+static struct timer sunxi_twd_timer;
+
 static void
 sunxi_twd_restart(const struct device *dev)
 {
@@ -32,6 +38,12 @@ sunxi_twd_restart(const struct device *dev)
 	mmio_write_32(self->regs + TWD_RESTART_REG, TWD_RESTART_KEY | BIT(0));
 }
 
+static void
+sunxi_twd_timer_fn(struct timer *timer UNUSED)
+{
+	sunxi_twd_restart(&r_twd.dev);
+}
+
 static void
 sunxi_twd_set_timeout(const struct device *dev, uint32_t timeout)
 {
@@ -66,6 +78,9 @@ sunxi_twd_probe(const struct device *dev)
 	/* Start the watchdog counter; enable system reset. */
 	mmio_clrset_32(regs + TWD_CTRL_REG, BIT(1), BIT(9));
 
+	/* Restart the watchdog periodically from the main loop. */
+	timer_start(&sunxi_twd_timer, sunxi_twd_timer_fn, TWD_INTERVAL, true);
+
 	return SUCCESS;
 }
 
@@ -74,6 +89,8 @@ sunxi_twd_release(const struct device *dev)
 {
 	const struct simple_device *self = to_simple_device(dev);
 
+	timer_stop(&sunxi_twd_timer);
+
 	/* Disable system reset; stop the watchdog counter. */
 	mmio_clrset_32(self->regs + TWD_CTRL_REG, BIT(9), BIT(1));
 
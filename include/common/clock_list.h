@@ -0,0 +1,32 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef COMMON_CLOCK_LIST_H
+#define COMMON_CLOCK_LIST_H
+
+#include <clock.h>
+#include <stdint.h>
+
+/**
+ * A clock made visible to SCPI clients. The clock's SCPI ID is its index in
+ * the list.
+ */
+struct scpi_clock {
+	struct clock_handle clock; /**< The clock and its provider. */
+	const char         *name;  /**< The name reported to clients. */
+	uint8_t             flags; /**< Allowed operations (SCPI_FLAG_*). */
+};
+
+/**
+ * The list of clocks made visible to SCPI clients.
+ */
+extern const struct scpi_clock scpi_clocks[];
+
+/**
+ * The number of entries in the list of clocks.
+ */
+extern const uint8_t scpi_clock_count;
+
+#endif /* COMMON_CLOCK_LIST_H */
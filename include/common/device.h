@@ -8,6 +8,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <timer.h>
 
 /**
  * Default initializer for the device state pointer.
@@ -18,6 +19,13 @@
  */
 #define DEVICE_STATE_INIT &(struct device_state) { 0 }
 
+/**
+ * Initializer for the state pointer of a device whose driver has a nonzero
+ * autosuspend delay.
+ */
+#define DEVICE_AUTOSUSPEND_STATE_INIT \
+	(struct device_state *) &(struct device_autosuspend_state) { { 0 } }
+
 struct device_state;
 struct driver;
 
@@ -35,11 +43,27 @@ struct device_state {
 	uint8_t refcount;
 };
 
+struct device_autosuspend_state {
+	struct device_state              ds;
+	/** Releases the device once it has been idle for long enough. */
+	struct timer                     timer;
+	/** The device, recorded when its last reference is released. */
+	const struct device             *dev;
+	/** The next device in the list of idle devices. */
+	struct device_autosuspend_state *next;
+};
+
 struct driver {
 	/** A function called to detect and initialize new devices. */
-	int  (*probe)(const struct device *dev);
+	int      (*probe)(const struct device *dev);
 	/** A function called to uninitialize devices and free resources. */
-	void (*release)(const struct device *dev);
+	void     (*release)(const struct device *dev);
+	/**
+	 * Time in microseconds to keep a device initialized after its last
+	 * reference is released, or zero to release it immediately. Devices
+	 * with a nonzero delay must use DEVICE_AUTOSUSPEND_STATE_INIT.
+	 */
+	uint32_t autosuspend_delay;
 };
 
 /**
@@ -77,10 +101,28 @@ const struct device *device_get_or_null(const struct device *dev);
 /**
  * Release a reference to a device.
  *
+ * If this is the last reference, and the driver has an autosuspend delay,
+ * the device is released after that delay, unless it is used again first.
+ *
  * @param dev A reference to a device.
  */
 void device_put(const struct device *dev);
 
+/**
+ * Immediately release all devices waiting for their autosuspend delay.
+ *
+ * This must be called before handing shared devices back to another agent,
+ * and before gating power to the SoC.
+ */
+void device_release_idle(void);
+
+/**
+ * Immediately release a device if it is waiting for its autosuspend delay.
+ *
+ * @param dev A reference to a device.
+ */
+void device_release_if_idle(const struct device *dev);
+
 /**
  * Implementation of the device probe function that does nothing.
  */
@@ -7,6 +7,18 @@
 #define COMMON_REGULATOR_LIST_H
 
 #include <regulator.h>
+#include <stdint.h>
+
+/**
+ * A regulator made visible to SCPI clients as a power supply. The supply's
+ * SCPI ID is its index in the list.
+ */
+struct scpi_psu {
+	/** The regulator and its supplier. */
+	const struct regulator_handle *regulator;
+	/** Allowed operations (SCPI_FLAG_*). */
+	uint8_t                        flags;
+};
 
 /**
  * The regulator supplying VDD-CPUX.
@@ -28,4 +40,37 @@ extern const struct regulator_handle vcc_pll_supply;
  */
 extern const struct regulator_handle vdd_sys_supply;
 
+/**
+ * The list of power supplies made visible to SCPI clients.
+ */
+extern const struct scpi_psu scpi_psus[];
+
+/**
+ * The number of entries in the list of power supplies.
+ */
+extern const uint8_t scpi_psu_count;
+
+/**
+ * Get the voltage of a power supply in the list, as last read by
+ * regulator_list_update(). The PMIC bus belongs to the rich OS while it is
+ * running, so the hardware is not accessed. After a firmware restart while
+ * the rich OS is running, no voltage is known until the next resume.
+ *
+ * This function may fail with:
+ *   EIO    The voltage could not be read.
+ *
+ * @param id      The index of the power supply in the list.
+ * @param voltage Pointer to where the voltage (in mV) is stored.
+ * @return        Zero on success; a defined error code on failure.
+ */
+int regulator_list_get_voltage(uint8_t id, uint32_t *voltage);
+
+/**
+ * Read the voltages of the power supplies in the list from the hardware.
+ *
+ * This function accesses the PMIC, so it must only be called while no other
+ * agent is using the PMIC bus.
+ */
+void regulator_list_update(void);
+
 #endif /* COMMON_REGULATOR_LIST_H */
@@ -0,0 +1,83 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef COMMON_SCMI_H
+#define COMMON_SCMI_H
+
+#include <device.h>
+#include <scmi_protocol.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * The maximum payload size of a message initiated by the SCP, in words.
+ */
+#define SCMI_QUEUED_PAYLOAD_WORDS 4
+
+#if CONFIG(SCMI)
+
+/**
+ * Create an SCMI message sent from the platform to the agent: a delayed
+ * response or a notification.
+ *
+ * The message is added to a small queue, and it is sent from scmi_poll()
+ * once the agent has freed the P2A shared memory area.
+ *
+ * This function may fail with:
+ *   EBUSY  The queue is full, and the message was dropped.
+ *
+ * @param header  The SCMI message header.
+ * @param payload The message payload.
+ * @param size    The size of the payload in bytes, at most
+ *                SCMI_QUEUED_PAYLOAD_WORDS words.
+ * @return        Zero on success; a defined error code on failure.
+ */
+int scmi_create_message(uint32_t header, const uint32_t *payload,
+                        uint8_t size);
+
+/**
+ * Handle a received SCMI command. This function parses the message, performs
+ * any requested actions, and writes the response to the same shared memory
+ * area.
+ *
+ * @param shmem The A2P shared memory area containing the command.
+ */
+void scmi_handle_cmd(struct scmi_shmem *shmem);
+
+/**
+ * Handle incoming SCMI commands and send queued messages as the shared
+ * memory areas become available.
+ *
+ * @return If some message is waiting for the agent, so polling must continue
+ *         without waiting for an IRQ.
+ *
+ * @param mailbox The message box device used for doorbells.
+ */
+bool scmi_poll(const struct device *mailbox);
+
+/**
+ * Notify the agent that a sensor value crossed its configured trip point.
+ *
+ * @param id    The index of the sensor in the sensor list.
+ * @param value The sampled value.
+ */
+void scmi_sensor_event(uint8_t id, uint32_t value);
+
+#else
+
+static inline bool
+scmi_poll(const struct device *mailbox UNUSED)
+{
+	return false;
+}
+
+static inline void
+scmi_sensor_event(uint8_t id UNUSED, uint32_t value UNUSED)
+{
+}
+
+#endif
+
+#endif /* COMMON_SCMI_H */
@@ -23,29 +23,60 @@ enum {
 };
 
 /**
- * Create and send an SCPI message. This is used for commands initiated by the
- * SCP.
+ * The maximum payload size of a message initiated by the SCP, in words.
+ */
+#define SCPI_QUEUED_PAYLOAD_WORDS 3
+
+/**
+ * Create an SCPI message. This is used for commands initiated by the SCP.
+ *
+ * The message is added to a small per-client queue, and it is sent from
+ * scpi_poll() once the client's TX buffer is free. Replies to commands from
+ * the client take priority over queued messages.
+ *
+ * This function may fail with:
+ *   EBUSY  The queue is full, and the message was dropped.
  *
- * @param mailbox The mailbox used to send the message.
  * @param client  The client that should receive the message.
  * @param command The command number to include in the message.
+ * @param payload The message payload, or NULL if the size is zero.
+ * @param size    The size of the payload in bytes, at most
+ *                SCPI_QUEUED_PAYLOAD_WORDS words.
+ * @return        Zero on success; a defined error code on failure.
+ */
+int scpi_create_message(uint8_t client, uint8_t command,
+                        const uint32_t *payload, uint8_t size);
+
+/**
+ * The possible results of handling an SCPI command.
  */
-void scpi_create_message(const struct device *mailbox, uint8_t client,
-                         uint8_t command);
+enum {
+	SCPI_HANDLED  = 0, /**< The command finished without a reply. */
+	SCPI_REPLY    = 1, /**< The command finished; send the reply. */
+	SCPI_DEFERRED = 2, /**< The command must be handled again later. */
+};
 
 /**
  * Handle a received SCPI command. This function parses the message, performs
  * any requested actions, and possibly generates a reply message.
  *
+ * A command that would need to wait for the hardware may be deferred instead.
+ * Its message is then kept in the RX buffer, and this function is called
+ * again for the same message from a later iteration of the main loop, until
+ * the command finishes. Other clients are serviced in the meantime.
+ *
  * @param  client The client from which the message was received.
  * @param  mem    The shared memory area containing the request and reply.
- * @return If the reply message is valid and should be sent to the client.
+ * @return One of the SCPI_HANDLED, SCPI_REPLY, or SCPI_DEFERRED results.
  */
-bool scpi_handle_cmd(uint8_t client, struct scpi_mem *mem);
+uint8_t scpi_handle_cmd(uint8_t client, struct scpi_mem *mem);
 
 /**
  * Handle incoming SCPI commands and send replies as buffers become available.
+ *
+ * @return If some client has not yet acknowledged a message, so polling must
+ *         continue without waiting for an IRQ.
  */
-void scpi_poll(const struct device *mailbox);
+bool scpi_poll(const struct device *mailbox);
 
 #endif /* COMMON_SCPI_H */
@@ -0,0 +1,92 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef COMMON_SENSOR_LIST_H
+#define COMMON_SENSOR_LIST_H
+
+#include <sensor.h>
+#include <stdint.h>
+
+/**
+ * A sensor made visible to SCPI clients. The sensor's SCPI ID is its index in
+ * the list.
+ */
+struct scpi_sensor {
+	/** The sensor and its provider. */
+	struct sensor_handle sensor;
+	/** The name reported to clients (at most 19 characters). */
+	const char          *name;
+	/** The class of the sensor (SCPI_SENSOR_*). */
+	uint8_t              class;
+};
+
+/**
+ * The list of sensors made visible to SCPI clients.
+ */
+extern const struct scpi_sensor scpi_sensors[];
+
+/**
+ * The number of entries in the list of sensors.
+ */
+extern const uint8_t scpi_sensor_count;
+
+/**
+ * Get the value of a sensor in the list.
+ *
+ * If the sensor is sampled periodically, the last sampled value is returned.
+ * Otherwise, the sensor is read immediately.
+ *
+ * This function may fail with:
+ *   EBUSY  The sensor has not yet produced a value.
+ *   EIO    There was a problem communicating with the hardware.
+ *   ENODEV The sensors are not available (the system is not awake).
+ *
+ * @param id    The index of the sensor in the list.
+ * @param value Pointer to where the value is stored.
+ * @return      Zero on success; a defined error code on failure.
+ */
+int sensor_list_get_value(uint8_t id, uint32_t *value);
+
+/**
+ * Set the bounds of a sensor in the list. Once bounds are set, the rich OS is
+ * sent an SCPI_CMD_ASYNC_SENSOR message each time a sampled value leaves the
+ * bounds.
+ *
+ * @param id    The index of the sensor in the list.
+ * @param lower The lower bound (inclusive).
+ * @param upper The upper bound (inclusive).
+ */
+void sensor_list_set_bounds(uint8_t id, uint32_t lower, uint32_t upper);
+
+/**
+ * Set the sampling period of a sensor in the list. A nonzero period also
+ * sends an SCPI_CMD_ASYNC_SENSOR message to the rich OS for each sample.
+ *
+ * This function may fail with:
+ *   ERANGE The period is too long to be represented by a timer.
+ *
+ * @param id     The index of the sensor in the list.
+ * @param period The sampling period in milliseconds, or zero to disable
+ *               periodic sampling.
+ * @return       Zero on success; a defined error code on failure.
+ */
+int sensor_list_set_period(uint8_t id, uint32_t period);
+
+/**
+ * Reset the sampling periods of all sensors in the list to their defaults.
+ */
+void sensor_list_init(void);
+
+/**
+ * Acquire the sensor providers and start periodic sampling.
+ */
+void sensor_list_resume(void);
+
+/**
+ * Stop periodic sampling and release the sensor providers.
+ */
+void sensor_list_suspend(void);
+
+#endif /* COMMON_SENSOR_LIST_H */
@@ -24,6 +24,13 @@ enum {
  */
 noreturn void system_state_machine(uint32_t exception);
 
+/**
+ * Cancel the timer set by system_set_wake_timer(), if it is armed.
+ *
+ * May be called at any time.
+ */
+void system_cancel_wake_timer(void);
+
 /**
  * Reboot the board, including the SoC and external peripherals.
  *
@@ -38,6 +45,21 @@ void system_reboot(void);
  */
 void system_reset(void);
 
+/**
+ * Arm a timer that wakes the system from suspend or shutdown, replacing any
+ * previously armed timer.
+ *
+ * The timer runs in all system states. If it expires while the system is
+ * awake, it has no effect.
+ *
+ * This function may fail with:
+ *   EIO    The timer device could not be acquired.
+ *
+ * @param useconds The delay from now until wakeup, in microseconds.
+ * @return         Zero on success; a defined error code on failure.
+ */
+int system_set_wake_timer(uint32_t useconds);
+
 /**
  * Shut down the SoC, and turn off all possible power domains.
  *
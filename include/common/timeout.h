@@ -12,22 +12,50 @@
 #define USEC_PER_MSEC 1000U
 #define USEC_PER_SEC  1000000U
 
+/**
+ * Convert a duration to a number of system counter cycles.
+ *
+ * @param useconds The duration in microseconds.
+ * @return         The number of counter cycles in that duration.
+ */
+uint64_t timeout_cycles(uint32_t useconds);
+
 /**
  * Check if a timeout has expired.
  *
  * @param timeout The timeout.
  * @return        Whether or not the timeout has expired.
  */
-bool timeout_expired(uint32_t timeout);
+bool timeout_expired(uint64_t timeout);
 
 /**
- * Set a timeout for some point in the near future.
+ * Set a timeout for some point in the future.
  *
- * Timeouts must not be set for greater than approximately one minute.
+ * The timeout is a value of the 64-bit system counter, so it never wraps.
  *
  * @param useconds The delay in microseconds before the timeout expires.
  * @return         An opaque number that can be passed to timeout_expired().
  */
-uint32_t timeout_set(uint32_t useconds);
+uint64_t timeout_set(uint32_t useconds);
+
+/**
+ * Convert a timeout set before the last call to timeout_update_rate(), so it
+ * expires after the same remaining duration at the new CPU clock rate.
+ *
+ * Remaining durations longer than 2^32 counter cycles are truncated.
+ *
+ * @param timeout A timeout returned by timeout_set().
+ * @return        The equivalent timeout at the current CPU clock rate.
+ */
+uint64_t timeout_rescale(uint64_t timeout);
+
+/**
+ * Recalculate the factor used to convert durations to system counter cycles.
+ *
+ * The system counter runs at the CPU clock rate, so this must be called
+ * whenever the CPU clock's parent or divider changes. Timeouts set before
+ * the change must be converted with timeout_rescale() to remain accurate.
+ */
+void timeout_update_rate(void);
 
 #endif /* COMMON_TIMEOUT_H */
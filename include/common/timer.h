@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef COMMON_TIMER_H
+#define COMMON_TIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+struct timer;
+
+typedef void timer_fn(struct timer *timer);
+
+/**
+ * A software timer. The structure is owned by the caller, and it must stay
+ * valid while the timer is running. A zero-initialized timer is stopped.
+ *
+ * Store timers in .bss, not .data, so they are reset by an exception restart.
+ */
+struct timer {
+	/** The next running timer, in deadline order. */
+	struct timer *next;
+	/** The function called when the timer expires, or NULL. */
+	timer_fn     *fn;
+	/** The 64-bit counter value at which the timer expires. */
+	uint64_t      deadline;
+	/** The timer period in microseconds, or zero for a one-shot timer. */
+	uint32_t      period;
+	/** Whether the timer is in the list of running timers. */
+	bool          running;
+};
+
+/**
+ * Get the deadline of the earliest running timer.
+ *
+ * If no timer is running, UINT64_MAX is returned instead.
+ *
+ * @return A timeout that can be passed to timeout_expired() or cpu_doze().
+ */
+uint64_t timer_next_deadline(void);
+
+/**
+ * Call the functions for all expired timers, in deadline order. One-shot
+ * timers are stopped before their function is called; periodic timers are
+ * restarted for their next period.
+ *
+ * This function must be called regularly from the main loop.
+ */
+void timer_poll(void);
+
+/**
+ * Determine if a timer is running (if it has not yet expired or been stopped).
+ *
+ * A timer with no function can be polled with this function to implement an
+ * interval check.
+ *
+ * @param timer A timer.
+ */
+bool timer_running(const struct timer *timer);
+
+/**
+ * Start a timer, or restart it if it is already running.
+ *
+ * @param timer    A timer.
+ * @param fn       The function to call when the timer expires, or NULL.
+ * @param useconds The delay in microseconds before the timer expires.
+ * @param periodic Whether the timer is restarted each time it expires.
+ */
+void timer_start(struct timer *timer, timer_fn *fn, uint32_t useconds,
+                 bool periodic);
+
+/**
+ * Update the timeout conversion factor after a CPU clock rate change, and
+ * adjust all running timers so they keep their remaining durations.
+ *
+ * This must be called instead of timeout_update_rate() once any timer could
+ * be running.
+ */
+void timer_update_rate(void);
+
+/**
+ * Stop a timer. This has no effect if the timer is not running.
+ *
+ * @param timer A timer.
+ */
+void timer_stop(struct timer *timer);
+
+#endif /* COMMON_TIMER_H */
@@ -69,7 +69,8 @@ int clock_get(const struct clock_handle *clock);
  * Get the current rate of a clock, as calculated from the hardware.
  *
  * This function returns the frequency the clock runs at when ungated,
- * regardless of if the clock is currently gated.
+ * regardless of if the clock is currently gated. The result is cached until
+ * the next call to clock_invalidate_rates().
  *
  * @param clock A reference to a clock.
  * @return      The clock frequency in Hz on success; zero on failure.
@@ -87,6 +88,70 @@ uint32_t clock_get_rate(const struct clock_handle *clock);
  */
 uint32_t clock_get_state(const struct clock_handle *clock);
 
+/**
+ * Determine the rate a clock would run at if clock_set_rate() was called.
+ *
+ * The result is the fastest supported rate that does not exceed the requested
+ * rate, based on the parent's current rate. If the requested rate is slower
+ * than any supported rate, the slowest supported rate is returned. Clocks
+ * without adjustable dividers return their current rate.
+ *
+ * @param clock A reference to a clock.
+ * @param rate  The requested clock frequency in Hz.
+ * @return      The clock frequency in Hz that would be set.
+ */
+uint32_t clock_round_rate(const struct clock_handle *clock, uint32_t rate);
+
+/**
+ * Change the parent of a clock.
+ *
+ * If the clock has outstanding references, a reference to the new parent is
+ * acquired before switching, and the reference to the old parent is released
+ * afterward. The caller is responsible for ensuring the resulting rate is
+ * acceptable to all consumers of the clock.
+ *
+ * This function may fail with:
+ *   EINVAL  The clock cannot use the requested parent.
+ *   EIO     There was a problem communicating with the hardware.
+ *   ENOTSUP The clock does not have a mux.
+ *
+ * @param clock  A reference to a clock.
+ * @param parent A handle specifying the new parent clock.
+ * @return       Zero on success; a defined error code on failure.
+ */
+int clock_set_parent(const struct clock_handle *clock,
+                     const struct clock_handle *parent);
+
+/**
+ * Change the rate of a clock, without changing its parent.
+ *
+ * The clock is set to the rate returned by clock_round_rate(). The caller is
+ * responsible for ensuring the new rate is acceptable to all consumers of the
+ * clock and of its descendants.
+ *
+ * This function may fail with:
+ *   EINVAL  No rate could be calculated from the parent's rate.
+ *   ENOTSUP The clock does not have adjustable dividers.
+ *
+ * @param clock A reference to a clock.
+ * @param rate  The requested clock frequency in Hz.
+ * @return      Zero on success; a defined error code on failure.
+ */
+int clock_set_rate(const struct clock_handle *clock, uint32_t rate);
+
+/**
+ * Discard all cached clock rates.
+ *
+ * Rates returned by clock_get_rate() are cached until any clock's parent or
+ * rate is changed through this API. This must be called after changing clock
+ * registers any other way.
+ *
+ * Clocks also controlled by other software (such as Linux) may change rate
+ * without notice. Callers that need an exact rate for those clocks should
+ * call this function first.
+ */
+void clock_invalidate_rates(void);
+
 /**
  * Release a reference to a clock and its controller device.
  *
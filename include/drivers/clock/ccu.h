@@ -8,6 +8,8 @@
 
 #include <clock.h>
 #include <device.h>
+#include <stdbool.h>
+#include <stdint.h>
 #if CONFIG(PLATFORM_A64)
 #include <clock/sun50i-a64-ccu.h>
 #include <clock/sun8i-r-ccu.h>
@@ -26,11 +28,31 @@ struct ccu {
 	struct device           dev;
 	const struct ccu_clock *clocks;
 	uintptr_t               regs;
+	uint8_t                 num_clocks;
 };
 
 extern const struct ccu ccu;
 extern const struct ccu r_ccu;
 
+/**
+ * Gate every clock in a CCU that has no references from the firmware, but
+ * was left running by another agent. The clocks are remembered so they can
+ * be restored by ccu_resume_unused().
+ *
+ * Only clocks described in the firmware's clock table are audited. Gates for
+ * peripherals the firmware does not know about are left untouched.
+ *
+ * @param self The CCU to audit.
+ */
+void ccu_suspend_unused(const struct ccu *self);
+
+/**
+ * Ungate the clocks previously gated by ccu_suspend_unused().
+ *
+ * @param self The CCU to restore.
+ */
+void ccu_resume_unused(const struct ccu *self);
+
 void ccu_suspend(void);
 void ccu_resume(void);
 void ccu_init(void);
@@ -39,4 +61,17 @@ void r_ccu_suspend(uint8_t depth);
 void r_ccu_resume(void);
 void r_ccu_init(void);
 
+/**
+ * Select the AR100 clock rate for the current firmware activity.
+ *
+ * While busy, the AR100 runs from a fast PLL if that PLL is running and
+ * locked. Otherwise, it runs from the lowest-power parent clock. Running
+ * timers are adjusted to the new rate.
+ *
+ * This has no effect on platforms without a governor.
+ *
+ * @param busy Whether the firmware has CPU-bound work to do.
+ */
+void r_ccu_set_busy(bool busy);
+
 #endif /* DRIVERS_CLOCK_CCU_H */
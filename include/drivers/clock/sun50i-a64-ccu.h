@@ -17,6 +17,7 @@ enum {
 	CLK_BUS_DRAM,
 	CLK_BUS_MSGBOX,
 	CLK_BUS_PIO,
+	CLK_BUS_THS,
 #if CONFIG(SERIAL_DEV_UART0)
 	CLK_BUS_UART0,
 #elif CONFIG(SERIAL_DEV_UART1)
@@ -30,6 +31,7 @@ enum {
 #endif
 	CLK_DRAM,
 	CLK_MBUS,
+	CLK_THS,
 	SUN50I_A64_CCU_CLOCKS
 };
 
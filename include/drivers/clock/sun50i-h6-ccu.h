@@ -7,6 +7,7 @@
 #define DRIVERS_CLOCK_SUN50I_H6_CCU_H
 
 enum {
+	CLK_PLL_CPUX,
 	CLK_PLL_DDR0,
 	CLK_PLL_PERIPH0,
 	CLK_APB2,
@@ -15,6 +16,7 @@ enum {
 	CLK_DRAM,
 	CLK_BUS_DRAM,
 	CLK_BUS_PIO,
+	CLK_BUS_THS,
 #if CONFIG(SERIAL_DEV_UART0)
 	CLK_BUS_UART0,
 #elif CONFIG(SERIAL_DEV_UART1)
@@ -14,6 +14,7 @@ enum {
 	CLK_BUS_DRAM,
 	CLK_BUS_MSGBOX,
 	CLK_BUS_PIO,
+	CLK_BUS_THS,
 #if CONFIG(SERIAL_DEV_UART0)
 	CLK_BUS_UART0,
 #elif CONFIG(SERIAL_DEV_UART1)
@@ -25,6 +26,7 @@ enum {
 #endif
 	CLK_DRAM,
 	CLK_MBUS,
+	CLK_THS,
 	SUN8I_H3_CCU_CLOCKS
 };
 
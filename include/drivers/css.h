@@ -6,8 +6,17 @@
 #ifndef COMMON_CSS_H
 #define COMMON_CSS_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
+/**
+ * A DVFS operating performance point (OPP) for a cluster.
+ */
+struct css_opp {
+	uint32_t rate;    /**< The CPU clock rate, in Hz. */
+	uint16_t voltage; /**< The CPU supply voltage, in mV. */
+};
+
 /**
  * Get the number of clusters in the compute subsystem.
  *
@@ -15,6 +24,36 @@
  */
 uint32_t css_get_cluster_count(void) ATTRIBUTE(const);
 
+/**
+ * Get the number of clusters supporting DVFS. These are always the clusters
+ * with the lowest indexes.
+ */
+uint32_t css_get_dvfs_count(void);
+
+/**
+ * Get the index of the current OPP of a cluster. If the CPU clock is not
+ * running at the rate of any OPP, this is the fastest OPP slower than the
+ * actual rate, or the slowest OPP.
+ *
+ * @param cluster The index of the cluster.
+ * @param opp     Where to store the OPP index.
+ * @return        An SCPI success or error status.
+ */
+int css_get_opp(uint32_t cluster, uint32_t *opp);
+
+/**
+ * Get the table of OPPs supported by a cluster, sorted by increasing rate.
+ * Only the OPPs usable at the present supply voltage are counted.
+ *
+ * @param cluster The index of the cluster.
+ * @param opps    Where to store a pointer to the OPP table.
+ * @param count   Where to store the number of OPPs in the table.
+ * @param latency Where to store the worst-case transition latency, in us.
+ * @return        An SCPI success or error status.
+ */
+int css_get_opps(uint32_t cluster, const struct css_opp **opps,
+                 uint32_t *count, uint32_t *latency);
+
 /**
  * Get the state of a cluster and the cores it contains.
  *
@@ -32,6 +71,17 @@ uint32_t css_get_cluster_count(void) ATTRIBUTE(const);
 int css_get_power_state(uint32_t cluster, uint32_t *cluster_state,
                         uint32_t *online_cores);
 
+/**
+ * Determine if a CPU core is in the WFI state. A core must be in WFI before
+ * it can be turned off, so callers may use this function to wait for a core
+ * without blocking inside css_set_power_state().
+ *
+ * @param cluster The index of the cluster.
+ * @param core    The index of the core within the cluster.
+ * @return        Whether the core is in WFI, or true if the core is invalid.
+ */
+bool css_core_in_wfi(uint32_t cluster, uint32_t core);
+
 /**
  * Initialize the CSS driver, assuming the CSS is already running. Since the
  * firmware starts after the CSS, the driver may need to synchronize its state
@@ -39,6 +89,49 @@ int css_get_power_state(uint32_t cluster, uint32_t *cluster_state,
  */
 void css_init(void);
 
+/**
+ * Switch a cluster to a different OPP. Only the CPU clock rate is changed,
+ * so the OPP must be usable at the present supply voltage.
+ *
+ * @param cluster The index of the cluster.
+ * @param opp     The index of the OPP in the cluster's OPP table.
+ * @return        An SCPI success or error status.
+ */
+int css_set_opp(uint32_t cluster, uint32_t opp);
+
+/**
+ * Hold the CPU clocks of all DVFS-capable clusters at their slowest OPP, for
+ * example to limit the SoC temperature. While throttled, OPP changes are
+ * recorded but not applied. Releasing the throttle applies the most recently
+ * requested OPP.
+ *
+ * The clocks are only throttled once a client has selected an OPP, since
+ * otherwise the rich OS may control the CPU clock itself.
+ *
+ * @param throttle Whether to throttle the CPU clocks.
+ * @return         Whether the CPU clocks are now throttled.
+ */
+bool css_set_throttle(bool throttle);
+
+/**
+ * Determine which OPPs each cluster can use at its present supply voltage.
+ * The voltage is never changed at runtime, since the PMIC bus is shared with
+ * the rich OS. Until this function or css_restore_opp_limits() is called, no
+ * OPPs are usable.
+ *
+ * This function accesses the PMIC, so it must only be called while no other
+ * agent is using the PMIC bus.
+ */
+void css_update_opp_limits(void);
+
+/**
+ * Recover the OPP limits after a firmware restart while the rich OS is
+ * running, without accessing the PMIC. Only the OPPs up to the present CPU
+ * clock rate are known to be valid at the present supply voltage, so this
+ * may hide OPPs until the next call to css_update_opp_limits().
+ */
+void css_restore_opp_limits(void);
+
 /**
  * Set the state of a CPU core and its ancestor power domains. There are no
  * restrictions on the requested power states; the best available power state
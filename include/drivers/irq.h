@@ -8,6 +8,37 @@
 
 #include <stdint.h>
 
+/**
+ * Disable an IRQ, so it no longer wakes the CPU from doze mode.
+ *
+ * @param irq The IRQ number, as listed in platform/irq.h.
+ */
+void irq_disable(uint32_t irq);
+
+/**
+ * Enable and unmask an IRQ, so it wakes the CPU from doze mode. Any pending
+ * instance of the IRQ is cleared first.
+ *
+ * This must be called again after the IRQ is handled, since the interrupt
+ * handler masks it.
+ *
+ * @param irq The IRQ number, as listed in platform/irq.h.
+ */
+void irq_enable(uint32_t irq);
+
+/**
+ * Mask the pending IRQs enabled by irq_enable(). This is called from the
+ * external interrupt handler, so the interrupt is not immediately taken again
+ * after returning. The IRQs are expected to be serviced by polling from the
+ * main loop.
+ *
+ * IRQs owned by the rich OS are never masked. If one of them is pending, the
+ * interrupt handler returns with interrupts disabled instead.
+ *
+ * @return Nonzero if some IRQ not enabled by irq_enable() is pending.
+ */
+uint32_t irq_handle(void);
+
 /**
  * Determine if any enabled IRQ requires AVCC in order to be received.
  *
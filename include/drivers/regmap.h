@@ -8,11 +8,85 @@
 
 #include <device.h>
 #include <intrusive.h>
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
+#include <timeout.h>
+#include <util.h>
+
+/** Time to keep regmap providers initialized between accesses. */
+#define REGMAP_AUTOSUSPEND_DELAY \
+	(CONFIG_REGMAP_AUTOSUSPEND_DELAY * USEC_PER_MSEC)
+
+/**
+ * An inclusive range of registers.
+ */
+struct regmap_range {
+	uint8_t first;
+	uint8_t last;
+};
+
+/**
+ * A cache of register values, used to skip bus transactions for registers
+ * whose value is already known. Registers that change on their own, or that
+ * have side effects when written, must be listed as volatile.
+ */
+struct regmap_cache {
+	/** Cached register values, indexed by register. */
+	uint8_t                   *values;
+	/** Bitmap of registers with a valid cached value. */
+	uint32_t                  *valid;
+	/** Copy of the global cache generation when the values were valid. */
+	uint32_t                  *generation;
+	/** Ranges of registers that are never cached. */
+	const struct regmap_range *volatile_ranges;
+	/** The number of entries in the volatile range list. */
+	uint8_t                    volatile_count;
+	/** The highest cached register. Higher registers are not cached. */
+	uint8_t                    max_reg;
+};
+
+/**
+ * Define the storage and descriptor for a regmap cache.
+ *
+ * @param name    The name of the regmap_cache object to define.
+ * @param max     The highest register to cache.
+ * @param ranges  An array of volatile regmap_range entries.
+ */
+#define DEFINE_REGMAP_CACHE(name, max, ranges) \
+	static uint8_t  name ## _values[(max) + 1]; \
+	static uint32_t name ## _valid[(max) / 32 + 1]; \
+	static uint32_t name ## _generation; \
+	static const struct regmap_cache name = { \
+		.values          = name ## _values, \
+		.valid           = name ## _valid, \
+		.generation      = &name ## _generation, \
+		.volatile_ranges = ranges, \
+		.volatile_count  = ARRAY_SIZE(ranges), \
+		.max_reg         = (max), \
+	}
+
+/**
+ * Refer to a regmap cache defined with DEFINE_REGMAP_CACHE(), or to no cache
+ * if register caching is disabled, so the unused cache storage is discarded.
+ *
+ * @param name    The name of the regmap_cache object.
+ */
+#define REGMAP_CACHE(name) (CONFIG(REGMAP_CACHE) ? &(name) : NULL)
+
+/**
+ * One step in a register sequence: an update of a bitfield in a register.
+ */
+struct regmap_seq_step {
+	uint8_t reg;  /**< The register to modify. */
+	uint8_t mask; /**< The bits to modify. */
+	uint8_t val;  /**< The new value of the bits in the mask. */
+};
 
 struct regmap {
-	const struct device *dev;
-	uint32_t             id;
+	const struct device       *dev;
+	const struct regmap_cache *cache; /**< Optional register cache. */
+	uint32_t                   id;
 };
 
 struct regmap_device {
@@ -50,6 +124,17 @@ int regmap_get(const struct regmap *map);
  */
 void regmap_put(const struct regmap *map);
 
+/**
+ * Allow or forbid the use of regmap caches.
+ *
+ * Caches must only be used while no other agent (for example, the rich OS)
+ * can access the same devices. Forbidding their use discards all cached
+ * values. Caches are initially forbidden.
+ *
+ * @param enabled Whether regmap caches may be used.
+ */
+void regmap_cache_set_enabled(bool enabled);
+
 /**
  * Read a value from a regmap.
  *
@@ -64,7 +149,8 @@ void regmap_put(const struct regmap *map);
 int regmap_read(const struct regmap *map, uint8_t reg, uint8_t *val);
 
 /**
- * Write a value to a regmap.
+ * Write a value to a regmap. If the regmap has a cache, and the register is
+ * known to already contain the value, no bus transaction is performed.
  *
  * This function may fail with:
  *   EIO     There was a problem communicating with the hardware.
@@ -76,6 +162,38 @@ int regmap_read(const struct regmap *map, uint8_t reg, uint8_t *val);
  */
 int regmap_write(const struct regmap *map, uint8_t reg, uint8_t val);
 
+/**
+ * Read a block of consecutive registers from a regmap, using as few bus
+ * transactions as the provider allows.
+ *
+ * This function may fail with:
+ *   EIO     There was a problem communicating with the hardware.
+ *
+ * @param map   A reference to the regmap.
+ * @param reg   The first register to read.
+ * @param vals  The location to save the values read from the registers.
+ * @param count The number of registers to read.
+ * @return      Zero on success; an error code on failure.
+ */
+int regmap_bulk_read(const struct regmap *map, uint8_t reg, uint8_t *vals,
+                     uint8_t count);
+
+/**
+ * Write a block of consecutive registers in a regmap, using as few bus
+ * transactions as the provider allows.
+ *
+ * This function may fail with:
+ *   EIO     There was a problem communicating with the hardware.
+ *
+ * @param map   A reference to the regmap.
+ * @param reg   The first register to write.
+ * @param vals  The values to write to the registers.
+ * @param count The number of registers to write.
+ * @return      Zero on success; an error code on failure.
+ */
+int regmap_bulk_write(const struct regmap *map, uint8_t reg,
+                      const uint8_t *vals, uint8_t count);
+
 /**
  * Update a bitfield in a regmap register.
  *
@@ -91,6 +209,25 @@ int regmap_write(const struct regmap *map, uint8_t reg, uint8_t val);
 int regmap_update_bits(const struct regmap *map, uint8_t reg, uint8_t mask,
                        uint8_t val);
 
+/**
+ * Apply a sequence of bitfield updates to a regmap. The steps must be sorted
+ * by register.
+ *
+ * Steps that modify the same register are merged into a single update, and
+ * updates to up to four adjacent registers use one bulk read and one bulk
+ * write. A register is only written if its value changes.
+ *
+ * This function may fail with:
+ *   EIO     There was a problem communicating with the hardware.
+ *
+ * @param map   A reference to the regmap.
+ * @param seq   The steps to apply.
+ * @param count The number of steps in the sequence.
+ * @return      Zero on success; an error code on failure.
+ */
+int regmap_run_sequence(const struct regmap *map,
+                        const struct regmap_seq_step *seq, uint8_t count);
+
 /**
  * Clear bits in a regmap register.
  *
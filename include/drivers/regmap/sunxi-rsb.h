@@ -11,4 +11,16 @@
 
 extern const struct simple_device r_rsb;
 
+/**
+ * Fall back to the default RSB bus clock rate, after the configured rate
+ * failed to communicate with a device. The new rate takes effect the next
+ * time the controller is probed.
+ *
+ * This function may fail with:
+ *   ENOTSUP The bus is already using the default rate.
+ *
+ * @return Zero on success; an error code on failure.
+ */
+int sunxi_rsb_reduce_rate(void);
+
 #endif /* DRIVERS_REGMAP_SUNXI_RSB_H */
@@ -9,6 +9,9 @@
 #include <device.h>
 #include <stdint.h>
 
+/** The most regulators that can be passed to regulator_disable_list(). */
+#define REGULATOR_LIST_MAX 4
+
 struct regulator_handle {
 	const struct device *dev; /**< The regulator supplier device. */
 	uint8_t              id;  /**< The device-specific identifier. */
@@ -28,6 +31,23 @@ struct regulator_handle {
  */
 int regulator_disable(const struct regulator_handle *handle);
 
+/**
+ * Disable the outputs of several regulators. Regulators with the same
+ * supplier are disabled together, using as few hardware accesses as the
+ * supplier allows.
+ *
+ * This function will acquire and release a reference to each supplier device.
+ *
+ * This function may fail with:
+ *   EIO    There was a problem communicating with the hardware.
+ *
+ * @param handles The regulators to disable.
+ * @param count   The number of regulators, at most REGULATOR_LIST_MAX.
+ * @return        Zero on success; the first error code on failure.
+ */
+int regulator_disable_list(const struct regulator_handle *const *handles,
+                           uint8_t count);
+
 /**
  * Enable the output of a regulator. If the regulator does not have
  * output on/off control, this function may have no effect on the hardware.
@@ -42,6 +62,20 @@ int regulator_disable(const struct regulator_handle *handle);
  */
 int regulator_enable(const struct regulator_handle *handle);
 
+/**
+ * Get the time needed for the output of a regulator to rise into regulation
+ * after it is enabled. If the regulator driver cannot determine the time, or
+ * there is a problem communicating with the hardware, a conservative value is
+ * returned instead.
+ *
+ * This function will acquire and release a reference to the supplier device.
+ *
+ * @param handle A reference to a regulator and its supplier.
+ * @return       The rise time in microseconds, or zero if the handle does not
+ *               refer to a regulator device.
+ */
+uint32_t regulator_get_ramp_time(const struct regulator_handle *handle);
+
 /**
  * Get the current state of a regulator, as determined from the hardware.
  *
@@ -54,4 +88,20 @@ int regulator_enable(const struct regulator_handle *handle);
  */
 int regulator_get_state(const struct regulator_handle *handle, bool *enabled);
 
+/**
+ * Get the output voltage of a regulator, as determined from the hardware.
+ *
+ * This function will acquire and release a reference to the supplier device.
+ *
+ * This function may fail with:
+ *   EIO     There was a problem communicating with the hardware.
+ *   ENOTSUP The regulator does not have adjustable output voltage.
+ *
+ * @param handle  A reference to a regulator and its supplier.
+ * @param voltage Pointer to where the voltage (in mV) is stored.
+ * @return        Zero on success; a defined error code on failure.
+ */
+int regulator_get_voltage(const struct regulator_handle *handle,
+                          uint32_t *voltage);
+
 #endif /* DRIVERS_REGULATOR_H */
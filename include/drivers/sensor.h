@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef DRIVERS_SENSOR_H
+#define DRIVERS_SENSOR_H
+
+#include <device.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+struct sensor_handle {
+	const struct device *dev; /**< The sensor provider device. */
+	uint8_t              id;  /**< The device-specific identifier. */
+};
+
+/**
+ * Determine if a sensor's values are calibrated, so they are accurate enough
+ * for the firmware to act on them.
+ *
+ * The caller must hold a reference to the provider device.
+ *
+ * @param handle A reference to a sensor and its provider.
+ * @return       Whether the sensor is calibrated.
+ */
+bool sensor_calibrated(const struct sensor_handle *handle);
+
+/**
+ * Read the current value of a sensor. Temperatures are measured in
+ * millidegrees Celsius.
+ *
+ * The caller must hold a reference to the provider device, since a sensor
+ * may need time to produce its first value after the device is probed.
+ *
+ * This function may fail with:
+ *   EBUSY  The sensor has not yet produced a value.
+ *   EIO    There was a problem communicating with the hardware.
+ *
+ * @param handle A reference to a sensor and its provider.
+ * @param value  Pointer to where the value is stored.
+ * @return       Zero on success; a defined error code on failure.
+ */
+int sensor_read(const struct sensor_handle *handle, uint32_t *value);
+
+#endif /* DRIVERS_SENSOR_H */
@@ -0,0 +1,23 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef DRIVERS_SENSOR_SUNXI_THS_H
+#define DRIVERS_SENSOR_SUNXI_THS_H
+
+#include <clock.h>
+#include <device.h>
+#include <sensor.h>
+#include <stdint.h>
+
+struct sunxi_ths {
+	struct device       dev;
+	struct clock_handle bus_clock;
+	struct clock_handle mod_clock;
+	uintptr_t           regs;
+};
+
+extern const struct sunxi_ths ths;
+
+#endif /* DRIVERS_SENSOR_SUNXI_THS_H */
@@ -0,0 +1,44 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef DRIVERS_TIMER_SUNXI_TIMER_H
+#define DRIVERS_TIMER_SUNXI_TIMER_H
+
+#include <device.h>
+#include <simple_device.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+extern const struct simple_device r_timer;
+
+/**
+ * Check if the timer has expired since it was last started.
+ *
+ * @param dev A reference to the timer device.
+ * @return    Whether the timer has expired.
+ */
+bool sunxi_timer_poll(const struct device *dev);
+
+/**
+ * Get the time remaining until the timer expires.
+ *
+ * @param dev A reference to the timer device.
+ * @return    The remaining time in microseconds, or zero if the timer has
+ *            expired.
+ */
+uint32_t sunxi_timer_remaining(const struct device *dev);
+
+/**
+ * Start a one-shot countdown, replacing any previous countdown.
+ *
+ * The timer counts using the 32 kHz oscillator, so it keeps running at every
+ * suspend depth. The delay is rounded down to the oscillator period.
+ *
+ * @param dev      A reference to the timer device.
+ * @param useconds The delay until the timer expires, in microseconds.
+ */
+void sunxi_timer_start(const struct device *dev, uint32_t useconds);
+
+#endif /* DRIVERS_TIMER_SUNXI_TIMER_H */
@@ -0,0 +1,158 @@
+/*
+ * Copyright © 2021 The Crust Firmware Authors.
+ * SPDX-License-Identifier: BSD-3-Clause OR GPL-2.0-only
+ */
+
+#ifndef COMMON_SCMI_PROTOCOL_H
+#define COMMON_SCMI_PROTOCOL_H
+
+#include <stdint.h>
+#include <util.h>
+
+/** The size of a shared memory area, matching the SCPI message size. */
+#define SCMI_SHMEM_SIZE          0x100
+
+/** The size of the transport header, including the message header. */
+#define SCMI_SHMEM_HEADER_SIZE   0x1c
+
+/** The payload is represented as an array of 32-bit words. */
+#define SCMI_PAYLOAD_WORDS \
+	((SCMI_SHMEM_SIZE - SCMI_SHMEM_HEADER_SIZE) / sizeof(uint32_t))
+
+/** The maximum length of a name, including the terminating NUL. */
+#define SCMI_NAME_SIZE           16
+
+/** Shared memory channel status bits. */
+#define SCMI_CHANNEL_FREE        BIT(0)
+#define SCMI_CHANNEL_ERROR       BIT(1)
+
+/** Shared memory flags: the agent wants a completion interrupt. */
+#define SCMI_FLAG_INTERRUPT      BIT(0)
+
+/** Build a message header from its fields. */
+#define SCMI_HEADER(protocol, message, type, token) \
+	((message) | (type) << 8 | (protocol) << 10 | (token) << 18)
+
+/**
+ * Message types, defined by the SCMI specification.
+ */
+enum {
+	SCMI_TYPE_COMMAND          = 0,
+	SCMI_TYPE_DELAYED_RESPONSE = 2,
+	SCMI_TYPE_NOTIFICATION     = 3,
+};
+
+/**
+ * Status codes, defined by the SCMI specification.
+ */
+enum {
+	SCMI_SUCCESS            = 0,
+	SCMI_NOT_SUPPORTED      = -1,
+	SCMI_INVALID_PARAMETERS = -2,
+	SCMI_DENIED             = -3,
+	SCMI_NOT_FOUND          = -4,
+	SCMI_OUT_OF_RANGE       = -5,
+	SCMI_BUSY               = -6,
+	SCMI_COMMS_ERROR        = -7,
+	SCMI_GENERIC_ERROR      = -8,
+	SCMI_HARDWARE_ERROR     = -9,
+	SCMI_PROTOCOL_ERROR     = -10,
+};
+
+/**
+ * Protocol identifiers, defined by the SCMI specification.
+ */
+enum {
+	SCMI_PROTOCOL_BASE   = 0x10,
+	SCMI_PROTOCOL_POWER  = 0x11,
+	SCMI_PROTOCOL_SYSTEM = 0x12,
+	SCMI_PROTOCOL_PERF   = 0x13,
+	SCMI_PROTOCOL_CLOCK  = 0x14,
+	SCMI_PROTOCOL_SENSOR = 0x15,
+};
+
+/**
+ * Messages implemented by every protocol.
+ */
+enum {
+	SCMI_PROTOCOL_VERSION            = 0x0,
+	SCMI_PROTOCOL_ATTRIBUTES         = 0x1,
+	SCMI_PROTOCOL_MESSAGE_ATTRIBUTES = 0x2,
+};
+
+/**
+ * Base protocol messages.
+ */
+enum {
+	SCMI_BASE_DISCOVER_VENDOR                 = 0x3,
+	SCMI_BASE_DISCOVER_SUB_VENDOR             = 0x4,
+	SCMI_BASE_DISCOVER_IMPLEMENTATION_VERSION = 0x5,
+	SCMI_BASE_DISCOVER_LIST_PROTOCOLS         = 0x6,
+};
+
+/**
+ * Power domain management protocol messages.
+ */
+enum {
+	SCMI_POWER_DOMAIN_ATTRIBUTES = 0x3,
+	SCMI_POWER_STATE_SET         = 0x4,
+	SCMI_POWER_STATE_GET         = 0x5,
+};
+
+/**
+ * System power management protocol messages.
+ */
+enum {
+	SCMI_SYSTEM_POWER_STATE_SET = 0x3,
+};
+
+/**
+ * Performance domain management protocol messages.
+ */
+enum {
+	SCMI_PERF_DOMAIN_ATTRIBUTES = 0x3,
+	SCMI_PERF_DESCRIBE_LEVELS   = 0x4,
+	SCMI_PERF_LIMITS_SET        = 0x5,
+	SCMI_PERF_LIMITS_GET        = 0x6,
+	SCMI_PERF_LEVEL_SET         = 0x7,
+	SCMI_PERF_LEVEL_GET         = 0x8,
+};
+
+/**
+ * Clock management protocol messages.
+ */
+enum {
+	SCMI_CLOCK_ATTRIBUTES     = 0x3,
+	SCMI_CLOCK_DESCRIBE_RATES = 0x4,
+	SCMI_CLOCK_RATE_SET       = 0x5,
+	SCMI_CLOCK_RATE_GET       = 0x6,
+	SCMI_CLOCK_CONFIG_SET     = 0x7,
+};
+
+/**
+ * Sensor management protocol messages and notifications.
+ */
+enum {
+	SCMI_SENSOR_TRIP_POINT_EVENT  = 0x0,
+	SCMI_SENSOR_DESCRIPTION_GET   = 0x3,
+	SCMI_SENSOR_TRIP_POINT_NOTIFY = 0x4,
+	SCMI_SENSOR_TRIP_POINT_CONFIG = 0x5,
+	SCMI_SENSOR_READING_GET       = 0x6,
+};
+
+/**
+ * The memory structure representing a shared memory area, defined by the
+ * SCMI specification. All fields are 32-bit words, so no byte swapping is
+ * needed beyond what the hardware does.
+ */
+struct scmi_shmem {
+	uint32_t reserved0;
+	uint32_t status;
+	uint32_t reserved1[2];
+	uint32_t flags;
+	uint32_t length;
+	uint32_t header;
+	uint32_t payload[SCMI_PAYLOAD_WORDS];
+};
+
+#endif /* COMMON_SCMI_PROTOCOL_H */
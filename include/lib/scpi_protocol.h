@@ -91,6 +91,33 @@ enum {
 	SCPI_E_STATE    = 15, /**< Invalid or unattainable state requested. */
 };
 
+/**
+ * Flags describing the operations allowed on an SCPI clock or power supply.
+ */
+enum {
+	SCPI_FLAG_READABLE = BIT(0),
+	SCPI_FLAG_WRITABLE = BIT(1),
+};
+
+/**
+ * Sensor classes, defined by the SCPI protocol specification.
+ */
+enum {
+	SCPI_SENSOR_TEMPERATURE = 0,
+	SCPI_SENSOR_VOLTAGE     = 1,
+	SCPI_SENSOR_CURRENT     = 2,
+	SCPI_SENSOR_POWER       = 3,
+	SCPI_SENSOR_ENERGY      = 4,
+};
+
+/**
+ * Sensor trigger types, defined by the SCPI protocol specification.
+ */
+enum {
+	SCPI_TRIGGER_PERIODIC = BIT(0),
+	SCPI_TRIGGER_BOUNDS   = BIT(1),
+};
+
 /**
  * Possible CSS power domain states, as used in existing SCPI implementations.
  */
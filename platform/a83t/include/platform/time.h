@@ -6,10 +6,6 @@
 #ifndef PLATFORM_TIME_H
 #define PLATFORM_TIME_H
 
-#define CPUCLK_MHz 16
-#define CPUCLK_kHz (CPUCLK_MHz * 1000)
-#define CPUCLK_Hz  (CPUCLK_MHz * 1000000)
-
 #define REFCLK_MHZ 24
 #define REFCLK_KHZ (REFCLK_MHZ * 1000)
 #define REFCLK_HZ  (REFCLK_MHZ * 1000000)